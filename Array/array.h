@@ -3,8 +3,12 @@
 
 #define ARRAY_TRAITS_IMPLEMENTED
 
+#include <stddef.h>
+#include <algorithm>
 #include <stdexcept>
 
+#include "../Instrumentation/instrumentation.h"
+
 class ArrayOutOfRange : public std::out_of_range {
  public:
   ArrayOutOfRange() : std::out_of_range("ArrayOutOfRange") {
@@ -71,15 +75,13 @@ class Array {
   }
 
   void Fill(const T &value) {
-    for (size_t i = 0; i < N; ++i) {
-      array[i] = value;
-    }
+    INSTRUMENT_CALL("Array", "Fill");
+    std::fill_n(array, N, value);
   }
 
   void Swap(Array<T, N> &other) {
-    for (size_t i = 0; i < N; ++i) {
-      std::swap(array[i], other[i]);
-    }
+    INSTRUMENT_CALL("Array", "Swap");
+    std::swap_ranges(array, array + N, other.array);
   }
 };
 
@@ -0,0 +1,458 @@
+#ifndef MD_ARRAY_H_
+#define MD_ARRAY_H_
+
+#include <stddef.h>
+#include <algorithm>
+#include <stdexcept>
+
+#include "array.h"
+
+class MdArrayShapeMismatch : public std::invalid_argument {
+ public:
+  MdArrayShapeMismatch() : std::invalid_argument("MdArrayShapeMismatch") {
+  }
+};
+
+const size_t kMdArrayAlignment = 64;
+// Reductions keep this many independent partial results, so the additions don't form one dependency chain and
+// the compiler can put the partial results into one vector register.
+const size_t kMdArrayReductionLanes = 8;
+
+// Non-owning view of Rank dimensions: element (i_0, ..., i_{Rank - 1}) is data_[i_0 * strides_[0] + ...].
+// Slices of a view share its storage, so they are views of the same elements.
+template<class T, size_t Rank>
+class MdArrayView {
+ public:
+  static_assert(Rank > 0, "MdArrayView needs at least one dimension");
+
+  MdArrayView(T *data, const size_t (&extents)[Rank], const size_t (&strides)[Rank]) : data_(data) {
+    std::copy(extents, extents + Rank, extents_);
+    std::copy(strides, strides + Rank, strides_);
+  }
+
+  operator MdArrayView<const T, Rank>() const {  // NOLINT
+    return MdArrayView<const T, Rank>(data_, extents_, strides_);
+  }
+
+  size_t Extent(size_t dimension) const {
+    return extents_[dimension];
+  }
+
+  size_t Stride(size_t dimension) const {
+    return strides_[dimension];
+  }
+
+  size_t GetRank() const {
+    return Rank;
+  }
+
+  size_t GetNumElements() const {
+    size_t elements = 1;
+    for (size_t dimension = 0; dimension < Rank; ++dimension) {
+      elements *= extents_[dimension];
+    }
+    return elements;
+  }
+
+  T *Data() const {
+    return data_;
+  }
+
+  bool IsContiguous() const {
+    size_t stride = 1;
+    for (size_t dimension = Rank; dimension-- > 0;) {
+      if (extents_[dimension] != 1 && strides_[dimension] != stride) {
+        return false;
+      }
+      stride *= extents_[dimension];
+    }
+    return true;
+  }
+
+  template<class... Indices>
+  T &operator()(Indices... indices) const {
+    static_assert(sizeof...(Indices) == Rank, "Wrong number of indices");
+    size_t index[] = {static_cast<size_t>(indices)...};
+    size_t offset = 0;
+    for (size_t dimension = 0; dimension < Rank; ++dimension) {
+      offset += index[dimension] * strides_[dimension];
+    }
+    return data_[offset];
+  }
+
+  template<class... Indices>
+  T &At(Indices... indices) const {
+    size_t index[] = {static_cast<size_t>(indices)...};
+    for (size_t dimension = 0; dimension < Rank; ++dimension) {
+      if (index[dimension] >= extents_[dimension]) {
+        throw ArrayOutOfRange();
+      }
+    }
+    return (*this)(indices...);
+  }
+
+  // Fixes index along Dimension and returns the view of the remaining dimensions.
+  template<size_t Dimension = 0>
+  MdArrayView<T, Rank - 1> Slice(size_t index) const {
+    static_assert(Rank > 1 && Dimension < Rank, "Wrong slice dimension");
+    size_t extents[Rank - 1];
+    size_t strides[Rank - 1];
+    for (size_t dimension = 0, k = 0; dimension < Rank; ++dimension) {
+      if (dimension != Dimension) {
+        extents[k] = extents_[dimension];
+        strides[k] = strides_[dimension];
+        ++k;
+      }
+    }
+    return MdArrayView<T, Rank - 1>(data_ + index * strides_[Dimension], extents, strides);
+  }
+
+  // Reinterprets a contiguous view with other extents in row-major order.
+  template<size_t... Dims>
+  MdArrayView<T, sizeof...(Dims)> Reshape() const {
+    constexpr size_t kExtents[] = {Dims...};
+    if (!IsContiguous() || (Dims * ... * 1) != GetNumElements()) {
+      throw MdArrayShapeMismatch();
+    }
+    size_t extents[sizeof...(Dims)];
+    size_t strides[sizeof...(Dims)];
+    for (size_t dimension = sizeof...(Dims), stride = 1; dimension-- > 0;) {
+      extents[dimension] = kExtents[dimension];
+      strides[dimension] = stride;
+      stride *= kExtents[dimension];
+    }
+    return MdArrayView<T, sizeof...(Dims)>(data_, extents, strides);
+  }
+
+  // Calls body(element) in row-major order: one flat loop for contiguous views, an index counter otherwise.
+  template<class Body>
+  void ForEach(Body body) const {
+    size_t elements = GetNumElements();
+    if (elements == 0) {
+      return;
+    }
+    if (IsContiguous()) {
+      for (size_t i = 0; i < elements; ++i) {
+        body(data_[i]);
+      }
+      return;
+    }
+    size_t index[Rank] = {};
+    size_t offset = 0;
+    size_t last = Rank - 1;
+    while (true) {
+      for (size_t i = 0; i < extents_[last]; ++i) {
+        body(data_[offset + i * strides_[last]]);
+      }
+      size_t dimension = last;
+      while (true) {
+        if (dimension == 0) {
+          return;
+        }
+        --dimension;
+        if (++index[dimension] < extents_[dimension]) {
+          offset += strides_[dimension];
+          break;
+        }
+        offset -= (extents_[dimension] - 1) * strides_[dimension];
+        index[dimension] = 0;
+      }
+    }
+  }
+
+  void Fill(const T &value) const {
+    if (IsContiguous()) {
+      std::fill_n(data_, GetNumElements(), value);
+    } else {
+      ForEach([&value](T &element) {
+        element = value;
+      });
+    }
+  }
+
+ private:
+  T *data_;
+  size_t extents_[Rank];
+  size_t strides_[Rank];
+};
+
+// Multi-dimensional array in one aligned row-major block. Index arithmetic uses compile-time extents, and bulk
+// operations are flat loops over Data(), which the compiler vectorizes.
+template<class T, size_t... Dims>
+class MdArray {
+ public:
+  static constexpr size_t kRank = sizeof...(Dims);
+  static constexpr size_t kNumElements = (Dims * ... * 1);
+  static_assert(kRank > 0 && kNumElements > 0, "MdArray needs non-empty dimensions");
+
+  static constexpr size_t Extent(size_t dimension) {
+    constexpr size_t kExtents[] = {Dims...};
+    return kExtents[dimension];
+  }
+
+  static constexpr size_t Stride(size_t dimension) {
+    size_t stride = 1;
+    for (size_t k = dimension + 1; k < kRank; ++k) {
+      stride *= Extent(k);
+    }
+    return stride;
+  }
+
+  template<class... Indices>
+  static constexpr size_t Offset(Indices... indices) {
+    static_assert(sizeof...(Indices) == kRank, "Wrong number of indices");
+    size_t index[] = {static_cast<size_t>(indices)...};
+    size_t offset = 0;
+    for (size_t dimension = 0; dimension < kRank; ++dimension) {
+      offset = offset * Extent(dimension) + index[dimension];
+    }
+    return offset;
+  }
+
+  template<class... Indices>
+  T &operator()(Indices... indices) {
+    return data_[Offset(indices...)];
+  }
+
+  template<class... Indices>
+  const T &operator()(Indices... indices) const {
+    return data_[Offset(indices...)];
+  }
+
+  template<class... Indices>
+  T &At(Indices... indices) {
+    CheckIndices(indices...);
+    return data_[Offset(indices...)];
+  }
+
+  template<class... Indices>
+  const T &At(Indices... indices) const {
+    CheckIndices(indices...);
+    return data_[Offset(indices...)];
+  }
+
+  T *Data() {
+    return data_;
+  }
+
+  const T *Data() const {
+    return data_;
+  }
+
+  T *begin() {  // NOLINT
+    return data_;
+  }
+
+  T *end() {  // NOLINT
+    return data_ + kNumElements;
+  }
+
+  const T *begin() const {  // NOLINT
+    return data_;
+  }
+
+  const T *end() const {  // NOLINT
+    return data_ + kNumElements;
+  }
+
+  size_t Size() const {
+    return kNumElements;
+  }
+
+  size_t GetRank() const {
+    return kRank;
+  }
+
+  size_t GetNumElements() const {
+    return kNumElements;
+  }
+
+  MdArrayView<T, kRank> View() {
+    size_t extents[kRank];
+    size_t strides[kRank];
+    GetShape(extents, strides);
+    return MdArrayView<T, kRank>(data_, extents, strides);
+  }
+
+  MdArrayView<const T, kRank> View() const {
+    size_t extents[kRank];
+    size_t strides[kRank];
+    GetShape(extents, strides);
+    return MdArrayView<const T, kRank>(data_, extents, strides);
+  }
+
+  template<size_t Dimension = 0>
+  MdArrayView<T, kRank - 1> Slice(size_t index) {
+    return View().template Slice<Dimension>(index);
+  }
+
+  template<size_t Dimension = 0>
+  MdArrayView<const T, kRank - 1> Slice(size_t index) const {
+    return View().template Slice<Dimension>(index);
+  }
+
+  template<size_t... NewDims>
+  MdArrayView<T, sizeof...(NewDims)> Reshape() {
+    static_assert((NewDims * ... * 1) == kNumElements, "Reshape must keep the number of elements");
+    return View().template Reshape<NewDims...>();
+  }
+
+  template<size_t... NewDims>
+  MdArrayView<const T, sizeof...(NewDims)> Reshape() const {
+    static_assert((NewDims * ... * 1) == kNumElements, "Reshape must keep the number of elements");
+    return View().template Reshape<NewDims...>();
+  }
+
+  void Fill(const T &value) {
+    INSTRUMENT_CALL("MdArray", "Fill");
+    std::fill_n(data_, kNumElements, value);
+  }
+
+  void Swap(MdArray &other) {
+    INSTRUMENT_CALL("MdArray", "Swap");
+    std::swap_ranges(data_, data_ + kNumElements, other.data_);
+  }
+
+  MdArray &operator+=(const MdArray &other) {
+    for (size_t i = 0; i < kNumElements; ++i) {
+      data_[i] += other.data_[i];
+    }
+    return *this;
+  }
+
+  MdArray &operator-=(const MdArray &other) {
+    for (size_t i = 0; i < kNumElements; ++i) {
+      data_[i] -= other.data_[i];
+    }
+    return *this;
+  }
+
+  MdArray &operator*=(const T &value) {
+    for (size_t i = 0; i < kNumElements; ++i) {
+      data_[i] *= value;
+    }
+    return *this;
+  }
+
+  MdArray &operator/=(const T &value) {
+    for (size_t i = 0; i < kNumElements; ++i) {
+      data_[i] /= value;
+    }
+    return *this;
+  }
+
+  friend MdArray operator+(const MdArray &left, const MdArray &right) {
+    MdArray result = left;
+    result += right;
+    return result;
+  }
+
+  friend MdArray operator-(const MdArray &left, const MdArray &right) {
+    MdArray result = left;
+    result -= right;
+    return result;
+  }
+
+  friend MdArray operator*(const MdArray &left, const T &value) {
+    MdArray result = left;
+    result *= value;
+    return result;
+  }
+
+  friend MdArray operator/(const MdArray &left, const T &value) {
+    MdArray result = left;
+    result /= value;
+    return result;
+  }
+
+  T Sum() const {
+    return Reduce([](const T &left, const T &right) {
+      return left + right;
+    });
+  }
+
+  T Min() const {
+    return Reduce([](const T &left, const T &right) {
+      return right < left ? right : left;
+    });
+  }
+
+  T Max() const {
+    return Reduce([](const T &left, const T &right) {
+      return left < right ? right : left;
+    });
+  }
+
+  friend bool operator==(const MdArray &left, const MdArray &right) {
+    return std::equal(left.data_, left.data_ + kNumElements, right.data_);
+  }
+
+  friend bool operator!=(const MdArray &left, const MdArray &right) {
+    return !(left == right);
+  }
+
+ private:
+  alignas(T) alignas(kMdArrayAlignment) T data_[kNumElements];
+
+  static void GetShape(size_t (&extents)[kRank], size_t (&strides)[kRank]) {
+    for (size_t dimension = 0; dimension < kRank; ++dimension) {
+      extents[dimension] = Extent(dimension);
+      strides[dimension] = Stride(dimension);
+    }
+  }
+
+  template<class... Indices>
+  static void CheckIndices(Indices... indices) {
+    size_t index[] = {static_cast<size_t>(indices)...};
+    for (size_t dimension = 0; dimension < kRank; ++dimension) {
+      if (index[dimension] >= Extent(dimension)) {
+        throw ArrayOutOfRange();
+      }
+    }
+  }
+
+  template<class Operation>
+  T Reduce(Operation operation) const {
+    if constexpr (kNumElements < kMdArrayReductionLanes) {
+      T result = data_[0];
+      for (size_t i = 1; i < kNumElements; ++i) {
+        result = operation(result, data_[i]);
+      }
+      return result;
+    } else {
+      T lanes[kMdArrayReductionLanes];
+      std::copy(data_, data_ + kMdArrayReductionLanes, lanes);
+      size_t i = kMdArrayReductionLanes;
+      for (; i + kMdArrayReductionLanes <= kNumElements; i += kMdArrayReductionLanes) {
+        for (size_t lane = 0; lane < kMdArrayReductionLanes; ++lane) {
+          lanes[lane] = operation(lanes[lane], data_[i + lane]);
+        }
+      }
+      for (; i < kNumElements; ++i) {
+        lanes[0] = operation(lanes[0], data_[i]);
+      }
+      T result = lanes[0];
+      for (size_t lane = 1; lane < kMdArrayReductionLanes; ++lane) {
+        result = operation(result, lanes[lane]);
+      }
+      return result;
+    }
+  }
+};
+
+template<class T, size_t... Dims>
+size_t GetSize(const MdArray<T, Dims...> &array) {
+  return array.Extent(0);
+}
+
+template<class T, size_t... Dims>
+size_t GetRank(const MdArray<T, Dims...> &array) {
+  return array.GetRank();
+}
+
+template<class T, size_t... Dims>
+size_t GetNumElements(const MdArray<T, Dims...> &array) {
+  return array.GetNumElements();
+}
+
+#endif
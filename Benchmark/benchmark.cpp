@@ -0,0 +1,281 @@
+#include <stddef.h>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+
+#include "../Array/md_array.h"
+#include "../BigInteger/big_integer.h"
+#include "../BigRational/big_rational.h"
+#include "../ConcurrentVector/concurrent_vector.h"
+#include "../Instrumentation/instrumentation.h"
+#include "../Matrix/matrix.h"
+#include "../Matrix/strassen.h"
+#include "../Vector/vector.h"
+
+// Every case runs its body in batches until kMinTime (kQuickMinTime with --quick) has passed and reports the mean time
+// per run.
+const double kMinTime = 0.5;
+const double kQuickMinTime = 0.05;
+
+struct BenchmarkOptions {
+  double min_time = kMinTime;
+  bool is_quick = false;
+  std::string filter;
+  std::string json_path;
+};
+
+// Keeps the compiler from removing computations whose results are otherwise unused.
+template<class T>
+void KeepAlive(const T &value) {
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "r"(&value) : "memory");
+#else
+  static const volatile void *sink;
+  sink = &value;
+#endif
+}
+
+void Run(const BenchmarkOptions &options, const std::string &name, size_t size, const std::function<void()> &body) {
+  std::string full_name = name + "/" + std::to_string(size);
+  if (!options.filter.empty() && full_name.find(options.filter) == std::string::npos) {
+    return;
+  }
+  body();
+  // The clock is read only between batches; a batch doubles until it takes kBatchShare of the minimal time, so
+  // reading the clock doesn't show in the time of fast bodies.
+  const double kBatchShare = 0.05;
+  size_t iterations = 0;
+  size_t batch = 1;
+  auto start = std::chrono::steady_clock::now();
+  auto batch_start = start;
+  double elapsed = 0;
+  do {
+    for (size_t i = 0; i < batch; ++i) {
+      body();
+    }
+    iterations += batch;
+    auto now = std::chrono::steady_clock::now();
+    elapsed = std::chrono::duration<double>(now - start).count();
+    if (std::chrono::duration<double>(now - batch_start).count() < options.min_time * kBatchShare) {
+      batch *= 2;
+    }
+    batch_start = now;
+  } while (elapsed < options.min_time);
+  std::printf("%-40s %12zu %16.1f ns\n", full_name.c_str(), iterations, elapsed * 1e9 / iterations);
+  std::fflush(stdout);
+}
+
+std::string RandomDigits(std::mt19937_64 &generator, size_t digits) {
+  std::string number(digits, '0');
+  for (auto &digit : number) {
+    digit = static_cast<char>('0' + generator() % 10);
+  }
+  number[0] = static_cast<char>('1' + generator() % 9);
+  return number;
+}
+
+// BigInteger keeps at most 30000 digits, so operands stop at 10^4 digits and products stay below the limit.
+void BenchmarkBigInteger(const BenchmarkOptions &options) {
+  std::mt19937_64 generator(1);
+  for (size_t digits : {100, 1000, 10000}) {
+    std::string left_digits = RandomDigits(generator, digits);
+    std::string right_digits = RandomDigits(generator, digits);
+    BigInteger left(left_digits.c_str());
+    BigInteger right(right_digits.c_str());
+    BigInteger product = left * right;
+    Run(options, "BigInteger/multiply", digits, [&] {
+      KeepAlive(left * right);
+    });
+    Run(options, "BigInteger/divide", digits, [&] {
+      KeepAlive(product / right);
+    });
+    Run(options, "BigInteger/print", digits, [&] {
+      std::ostringstream os;
+      os << left;
+      KeepAlive(os.str());
+    });
+    Run(options, "BigInteger/parse", digits, [&] {
+      KeepAlive(BigInteger(left_digits.data(), left_digits.data() + left_digits.size()));
+    });
+  }
+}
+
+template<size_t N>
+Matrix<double, N, N> RandomMatrix(std::mt19937_64 &generator) {
+  std::uniform_real_distribution<double> distribution(-1, 1);
+  Matrix<double, N, N> matrix;
+  for (size_t i = 0; i < N; ++i) {
+    for (size_t j = 0; j < N; ++j) {
+      matrix(i, j) = distribution(generator) + (i == j ? static_cast<double>(N) : 0);
+    }
+  }
+  return matrix;
+}
+
+template<size_t N>
+void BenchmarkMatrixMultiply(const BenchmarkOptions &options) {
+  std::mt19937_64 generator(N);
+  auto left = std::make_unique<Matrix<double, N, N>>(RandomMatrix<N>(generator));
+  auto right = std::make_unique<Matrix<double, N, N>>(RandomMatrix<N>(generator));
+  auto result = std::make_unique<Matrix<double, N, N>>();
+  Run(options, "Matrix/multiply", N, [&] {
+    *result = *left * *right;
+    KeepAlive(*result);
+  });
+  if (N >= kStrassenCutoff) {
+    Run(options, "Matrix/strassen", N, [&] {
+      *result = StrassenMultiply(*left, *right);
+      KeepAlive(*result);
+    });
+  }
+}
+
+// Determinant and GetInversed expand over minors, so they are measured at small sizes only.
+template<size_t N>
+void BenchmarkMatrixDeterminant(const BenchmarkOptions &options) {
+  std::mt19937_64 generator(N);
+  Matrix<double, N, N> matrix = RandomMatrix<N>(generator);
+  Run(options, "Matrix/determinant", N, [&] {
+    KeepAlive(Determinant(matrix));
+  });
+  Run(options, "Matrix/inverse", N, [&] {
+    KeepAlive(GetInversed(matrix));
+  });
+}
+
+void BenchmarkMatrix(const BenchmarkOptions &options) {
+  BenchmarkMatrixMultiply<4>(options);
+  BenchmarkMatrixMultiply<16>(options);
+  BenchmarkMatrixMultiply<64>(options);
+  BenchmarkMatrixMultiply<128>(options);
+  if (!options.is_quick) {
+    BenchmarkMatrixMultiply<256>(options);
+  }
+  BenchmarkMatrixDeterminant<2>(options);
+  BenchmarkMatrixDeterminant<3>(options);
+  BenchmarkMatrixDeterminant<4>(options);
+  BenchmarkMatrixDeterminant<6>(options);
+  if (!options.is_quick) {
+    BenchmarkMatrixDeterminant<8>(options);
+  }
+
+  Matrix<BigRational, 4, 4> rational;
+  for (size_t i = 0; i < 4; ++i) {
+    for (size_t j = 0; j < 4; ++j) {
+      rational(i, j) = static_cast<int64_t>((i * 7 + j * 3) % 11) + (i == j ? 11 : 0);
+    }
+  }
+  Run(options, "Matrix/inverse_rational", 4, [&] {
+    KeepAlive(GetInversed(rational));
+  });
+}
+
+void BenchmarkVector(const BenchmarkOptions &options) {
+  size_t max_size = options.is_quick ? 1000000 : 10000000;
+  for (size_t size = 1000; size <= max_size; size *= 10) {
+    Run(options, "Vector/push_back_int", size, [&] {
+      Vector<int> vector;
+      for (size_t i = 0; i < size; ++i) {
+        vector.PushBack(static_cast<int>(i));
+      }
+      KeepAlive(vector);
+    });
+    Run(options, "Vector/reserve_push_back_int", size, [&] {
+      Vector<int> vector;
+      vector.Reserve(size);
+      for (size_t i = 0; i < size; ++i) {
+        vector.PushBack(static_cast<int>(i));
+      }
+      KeepAlive(vector);
+    });
+  }
+  for (size_t size = 1000; size <= max_size / 10; size *= 10) {
+    Run(options, "Vector/push_back_string", size, [&] {
+      Vector<std::string> vector;
+      for (size_t i = 0; i < size; ++i) {
+        vector.EmplaceBack(32, 'x');
+      }
+      KeepAlive(vector);
+    });
+    Vector<std::string> source;
+    for (size_t i = 0; i < size; ++i) {
+      source.EmplaceBack(32, 'x');
+    }
+    Vector<std::string> target;
+    Run(options, "Vector/copy_assign_string", size, [&] {
+      target = source;
+      KeepAlive(target);
+    });
+    Run(options, "ConcurrentVector/push_back_int", size, [&] {
+      ConcurrentVector<int> vector;
+      for (size_t i = 0; i < size; ++i) {
+        vector.PushBack(static_cast<int>(i));
+      }
+      KeepAlive(vector);
+    });
+  }
+}
+
+void BenchmarkArray(const BenchmarkOptions &options) {
+  const size_t kSide = 1024;
+  auto array = std::make_unique<MdArray<float, kSide, kSide>>();
+  auto other = std::make_unique<MdArray<float, kSide, kSide>>();
+  array->Fill(1);
+  other->Fill(2);
+  Run(options, "MdArray/fill", kSide * kSide, [&] {
+    array->Fill(3);
+    KeepAlive(*array);
+  });
+  Run(options, "MdArray/add", kSide * kSide, [&] {
+    *array += *other;
+    KeepAlive(*array);
+  });
+  Run(options, "MdArray/sum", kSide * kSide, [&] {
+    KeepAlive(array->Sum());
+  });
+  Run(options, "MdArray/column_fill", kSide, [&] {
+    array->Slice<1>(7).Fill(0);
+    KeepAlive(*array);
+  });
+}
+
+int main(int argc, char **argv) {
+  BenchmarkOptions options;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--quick") == 0) {
+      options.is_quick = true;
+      options.min_time = kQuickMinTime;
+    } else if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+      options.filter = argv[++i];
+    } else if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+      options.json_path = argv[++i];
+    } else {
+      std::cerr << "Usage: " << argv[0] << " [--quick] [--filter substring] [--json counters.json]\n";
+      return 1;
+    }
+  }
+
+  std::printf("%-40s %12s %19s\n", "benchmark", "iterations", "time per run");
+  BenchmarkBigInteger(options);
+  BenchmarkMatrix(options);
+  BenchmarkVector(options);
+  BenchmarkArray(options);
+
+  if (!options.json_path.empty()) {
+#ifdef CONTAINERS_INSTRUMENTATION
+    std::ofstream json(options.json_path);
+    INSTRUMENT_WRITE_JSON(json);
+#else
+    std::cerr << "Counters are not available: configure with -DCONTAINERS_INSTRUMENTATION=ON\n";
+#endif
+  }
+  return 0;
+}
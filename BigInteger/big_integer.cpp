@@ -3,6 +3,8 @@
 #include <iostream>
 #include <stdexcept>
 
+#include "../Instrumentation/instrumentation.h"
+
 void BigInteger::RemoveLeadingZeros() {
   while (digits_.size() > 1 && digits_.back() == 0) {
     digits_.pop_back();
@@ -10,22 +12,42 @@ void BigInteger::RemoveLeadingZeros() {
 }
 
 void BigInteger::FromString(const std::string &str) {
-  digits_.clear();
-  digits_.reserve(str.size());
-  is_negative_ = (str[0] == '-');
-  std::string absolute_str = str;
-  if (-is_negative_ || str[0] == '+') {
-    absolute_str = str.substr(1, str.size());
+  FromChars(str.data(), str.data() + str.size());
+}
+
+void BigInteger::FromChars(const char *begin, const char *end) {
+  INSTRUMENT_CALL("BigInteger", "parse");
+  is_negative_ = begin != end && *begin == '-';
+  if (begin != end && (*begin == '-' || *begin == '+')) {
+    ++begin;
   }
-  for (size_t i = absolute_str.size() - 1; i < str.size(); i -= kDigitWidth) {
-    size_t end = i + 1;
-    size_t begin = i < kDigitWidth ? 0 : i - kDigitWidth + 1;
-    digits_.push_back(std::stoi(absolute_str.substr(begin, end - begin)));
+  if (begin == end) {
+    throw std::invalid_argument("BigInteger");
   }
-  RemoveLeadingZeros();
-  if (digits_.size() * kDigitWidth > kMaxDigits) {
+  // Leading zeros don't count towards kMaxDigits; longer tokens are rejected before anything is allocated.
+  while (end - begin > 1 && *begin == '0') {
+    ++begin;
+  }
+  if (end - begin > kMaxDigits) {
     throw BigIntegerOverflow();
   }
+  digits_.clear();
+  digits_.reserve((end - begin + kDigitWidth - 1) / kDigitWidth);
+  for (const char *chunk_end = end, *chunk_begin = end; chunk_end != begin; chunk_end = chunk_begin) {
+    chunk_begin = chunk_end - begin < kDigitWidth ? begin : chunk_end - kDigitWidth;
+    int digit = 0;
+    for (const char *c = chunk_begin; c != chunk_end; ++c) {
+      if (*c < '0' || *c > '9') {
+        throw std::invalid_argument("BigInteger");
+      }
+      digit = digit * 10 + (*c - '0');
+    }
+    digits_.push_back(digit);
+  }
+  RemoveLeadingZeros();
+  if (IsZero()) {
+    is_negative_ = false;
+  }
 }
 
 bool BigInteger::IsZero() const {
@@ -68,10 +90,18 @@ BigInteger::BigInteger(const char *str) {
   FromString(std::string(str));
 }
 
-bool BigInteger::IsNegative() {
+BigInteger::BigInteger(const char *begin, const char *end) {
+  FromChars(begin, end);
+}
+
+bool BigInteger::IsNegative() const {
   return is_negative_;
 }
 
+size_t BigInteger::DigitsNumber() const {
+  return digits_.size() * kDigitWidth;
+}
+
 BigInteger Abs(const BigInteger &n) {
   BigInteger absolute = n;
   absolute.is_negative_ = false;
@@ -84,11 +114,12 @@ BigInteger BigInteger::operator+() const {
 
 BigInteger BigInteger::operator-() const {
   BigInteger result = *this;
-  result.is_negative_ = !is_negative_;
+  result.is_negative_ = !is_negative_ && !IsZero();
   return result;
 }
 
 BigInteger operator+(const BigInteger &l, const BigInteger &r) {
+  INSTRUMENT_CALL("BigInteger", "operator+");
   BigInteger result;
   result.digits_ = std::vector<int>(l.digits_.size() + r.digits_.size() + 1, 0);
   size_t size = std::max(l.digits_.size(), r.digits_.size());
@@ -116,11 +147,12 @@ BigInteger operator+(const BigInteger &l, const BigInteger &r) {
   BigInteger r_abs = Abs(r);
   BigInteger l_abs = Abs(l);
   result.is_negative_ = l.is_negative_ ? r < l_abs : l < r_abs;
+  bool is_r_larger = r_abs >= l_abs;
   for (size_t i = 0; i < size || carry != 0; ++i) {
     int l_digit = i < l.digits_.size() ? l.digits_[i] : 0;
     int r_digit = i < r.digits_.size() ? r.digits_[i] : 0;
     int part_sum = 0;
-    if (Abs(r) >= Abs(l)) {
+    if (is_r_larger) {
       part_sum = r_digit - l_digit - carry;
     } else {
       part_sum = l_digit - r_digit - carry;
@@ -146,6 +178,7 @@ BigInteger operator-(const BigInteger &l, const BigInteger &r) {
 }
 
 BigInteger operator*(const BigInteger &l, const BigInteger &r) {
+  INSTRUMENT_CALL("BigInteger", "operator*");
   BigInteger result;
   result.digits_ = std::vector<int>(l.digits_.size() + r.digits_.size() + 1, 0);
   result.is_negative_ = l.is_negative_ ? !r.is_negative_ : r.is_negative_;
@@ -235,6 +268,7 @@ BigInteger &operator*=(int l, BigInteger &r) {
 }
 
 BigInteger operator/(const BigInteger &l, const BigInteger &r) {
+  INSTRUMENT_CALL("BigInteger", "operator/");
   if (r.IsZero()) {
     throw BigIntegerDivisionByZero();
   }
@@ -329,12 +363,13 @@ bool BigInteger::operator<(const BigInteger &other) const {
   if (is_negative_ != other.is_negative_) {
     return is_negative_;
   }
+  // Both have the same sign: a larger magnitude is smaller for negative numbers.
   if (digits_.size() != other.digits_.size()) {
-    return digits_.size() < other.digits_.size();
+    return (digits_.size() < other.digits_.size()) != is_negative_;
   }
   for (size_t i = digits_.size() - 1; i < digits_.size(); --i) {
     if (digits_[i] != other.digits_[i]) {
-      return digits_[i] < other.digits_[i];
+      return (digits_[i] < other.digits_[i]) != is_negative_;
     }
   }
   return false;
@@ -360,6 +395,7 @@ std::istream &operator>>(std::istream &is, BigInteger &big_integer) {
 }
 
 std::ostream &operator<<(std::ostream &os, const BigInteger &big_integer) {
+  INSTRUMENT_CALL("BigInteger", "operator<<");
   if (big_integer.is_negative_) {
     os << '-';
   }
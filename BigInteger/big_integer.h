@@ -3,6 +3,7 @@
 
 #define BIG_INTEGER_DIVISION_IMPLEMENTED
 
+#include <stddef.h>
 #include <cstdint>
 #include <string>
 #include <stdexcept>
@@ -30,6 +31,7 @@ class BigInteger {
 
   void RemoveLeadingZeros();
   void FromString(const std::string &);
+  void FromChars(const char *, const char *);
   bool IsZero() const;
   BigInteger Pow(const BigInteger &);
 
@@ -38,8 +40,10 @@ class BigInteger {
   explicit BigInteger(int);
   BigInteger(int64_t);       // NOLINT
   explicit BigInteger(const char *);
+  BigInteger(const char *, const char *);
 
-  bool IsNegative();
+  bool IsNegative() const;
+  size_t DigitsNumber() const;
   friend BigInteger Abs(const BigInteger &n);
 
   BigInteger operator+() const;
@@ -0,0 +1,221 @@
+#include "big_rational.h"
+#include <iostream>
+#include <string>
+#include <utility>
+
+static const BigInteger kOne(1);
+
+static BigInteger Gcd(BigInteger a, BigInteger b) {
+  a = Abs(a);
+  b = Abs(b);
+  while (b) {
+    a %= b;
+    std::swap(a, b);
+  }
+  return a;
+}
+
+void BigRational::Normalize() {
+  if (is_normalized_) {
+    return;
+  }
+  if (!numerator_) {
+    denominator_ = kOne;
+  } else if (denominator_ != kOne) {
+    BigInteger gcd = Gcd(numerator_, denominator_);
+    if (gcd != kOne) {
+      numerator_ /= gcd;
+      denominator_ /= gcd;
+    }
+  }
+  is_normalized_ = true;
+}
+
+void BigRational::NormalizeIfLarge() {
+  if (!is_normalized_ && numerator_.DigitsNumber() + denominator_.DigitsNumber() > kNormalizationThreshold) {
+    Normalize();
+  }
+}
+
+BigRational::BigRational() : denominator_(kOne), is_normalized_(true) {
+}
+
+BigRational::BigRational(int64_t value) : numerator_(value), denominator_(kOne), is_normalized_(true) {
+}
+
+BigRational::BigRational(const BigInteger &value) : numerator_(value), denominator_(kOne), is_normalized_(true) {
+}
+
+BigRational::BigRational(const BigInteger &numerator, const BigInteger &denominator)
+    : numerator_(numerator), denominator_(denominator), is_normalized_(false) {
+  if (!denominator_) {
+    throw BigRationalDivisionByZero();
+  }
+  if (denominator_.IsNegative()) {
+    numerator_ = -numerator_;
+    denominator_ = -denominator_;
+  }
+}
+
+BigInteger BigRational::Numerator() const {
+  if (is_normalized_) {
+    return numerator_;
+  }
+  BigRational reduced = *this;
+  reduced.Normalize();
+  return reduced.numerator_;
+}
+
+BigInteger BigRational::Denominator() const {
+  if (is_normalized_) {
+    return denominator_;
+  }
+  BigRational reduced = *this;
+  reduced.Normalize();
+  return reduced.denominator_;
+}
+
+bool BigRational::IsNegative() const {
+  return numerator_.IsNegative();
+}
+
+BigRational Abs(const BigRational &n) {
+  BigRational absolute = n;
+  absolute.numerator_ = Abs(absolute.numerator_);
+  return absolute;
+}
+
+BigRational BigRational::operator+() const {
+  return *this;
+}
+
+BigRational BigRational::operator-() const {
+  BigRational result = *this;
+  result.numerator_ = -numerator_;
+  return result;
+}
+
+BigRational operator+(const BigRational &l, const BigRational &r) {
+  BigRational result;
+  if (l.denominator_ == r.denominator_) {
+    result.numerator_ = l.numerator_ + r.numerator_;
+    result.denominator_ = l.denominator_;
+  } else {
+    result.numerator_ = l.numerator_ * r.denominator_ + r.numerator_ * l.denominator_;
+    result.denominator_ = l.denominator_ * r.denominator_;
+  }
+  result.is_normalized_ = result.denominator_ == kOne;
+  result.NormalizeIfLarge();
+  return result;
+}
+
+BigRational operator-(const BigRational &l, const BigRational &r) {
+  return l + (-r);
+}
+
+BigRational operator*(const BigRational &l, const BigRational &r) {
+  BigRational result;
+  result.numerator_ = l.numerator_ * r.numerator_;
+  result.denominator_ = l.denominator_ * r.denominator_;
+  result.is_normalized_ = result.denominator_ == kOne;
+  result.NormalizeIfLarge();
+  return result;
+}
+
+BigRational operator/(const BigRational &l, const BigRational &r) {
+  if (!r.numerator_) {
+    throw BigRationalDivisionByZero();
+  }
+  BigRational result;
+  result.numerator_ = l.numerator_ * r.denominator_;
+  result.denominator_ = l.denominator_ * r.numerator_;
+  if (result.denominator_.IsNegative()) {
+    result.numerator_ = -result.numerator_;
+    result.denominator_ = -result.denominator_;
+  }
+  result.is_normalized_ = result.denominator_ == kOne;
+  result.NormalizeIfLarge();
+  return result;
+}
+
+BigRational &operator+=(BigRational &l, const BigRational &r) {
+  return l = l + r;
+}
+
+BigRational &operator-=(BigRational &l, const BigRational &r) {
+  return l = l - r;
+}
+
+BigRational &operator*=(BigRational &l, const BigRational &r) {
+  return l = l * r;
+}
+
+BigRational &operator/=(BigRational &l, const BigRational &r) {
+  return l = l / r;
+}
+
+BigRational::operator bool() const {
+  return static_cast<bool>(numerator_);
+}
+
+bool operator==(const BigRational &l, const BigRational &r) {
+  if (l.denominator_ == r.denominator_) {
+    return l.numerator_ == r.numerator_;
+  }
+  if (!l.numerator_ || !r.numerator_) {
+    return !l.numerator_ && !r.numerator_;
+  }
+  if (l.numerator_.IsNegative() != r.numerator_.IsNegative()) {
+    return false;
+  }
+  return l.numerator_ * r.denominator_ == r.numerator_ * l.denominator_;
+}
+
+bool operator!=(const BigRational &l, const BigRational &r) {
+  return !(l == r);
+}
+
+bool operator<(const BigRational &l, const BigRational &r) {
+  if (l.denominator_ == r.denominator_) {
+    return l.numerator_ < r.numerator_;
+  }
+  if (l.numerator_.IsNegative() != r.numerator_.IsNegative()) {
+    return l.numerator_.IsNegative();
+  }
+  return l.numerator_ * r.denominator_ < r.numerator_ * l.denominator_;
+}
+
+bool operator>(const BigRational &l, const BigRational &r) {
+  return r < l;
+}
+
+bool operator<=(const BigRational &l, const BigRational &r) {
+  return !(r < l);
+}
+
+bool operator>=(const BigRational &l, const BigRational &r) {
+  return !(l < r);
+}
+
+std::istream &operator>>(std::istream &is, BigRational &big_rational) {
+  std::string input;
+  is >> input;
+  size_t slash = input.find('/');
+  if (slash == std::string::npos) {
+    big_rational = BigRational(BigInteger(input.data(), input.data() + input.size()));
+  } else {
+    big_rational = BigRational(BigInteger(input.data(), input.data() + slash),
+                               BigInteger(input.data() + slash + 1, input.data() + input.size()));
+  }
+  return is;
+}
+
+std::ostream &operator<<(std::ostream &os, const BigRational &big_rational) {
+  BigRational reduced = big_rational;
+  reduced.Normalize();
+  os << reduced.numerator_;
+  if (reduced.denominator_ != kOne) {
+    os << '/' << reduced.denominator_;
+  }
+  return os;
+}
@@ -0,0 +1,67 @@
+#ifndef BIG_RATIONAL_H_
+#define BIG_RATIONAL_H_
+
+#include <stddef.h>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+
+#include "../BigInteger/big_integer.h"
+
+class BigRationalDivisionByZero : public std::runtime_error {
+ public:
+  BigRationalDivisionByZero() : std::runtime_error("BigRationalDivisionByZero") {
+  }
+};
+
+// Exact fraction numerator_ / denominator_ with a positive denominator. Arithmetic doesn't reduce the fraction:
+// the gcd runs only when the operands grow past kNormalizationThreshold digits. Const members never modify the
+// object, so a shared BigRational can be read from several threads: comparisons cross-multiply, and printing,
+// Numerator and Denominator reduce a copy.
+class BigRational {
+ private:
+  BigInteger numerator_;
+  BigInteger denominator_;
+  bool is_normalized_;
+  static const size_t kNormalizationThreshold = 64;
+
+  void Normalize();
+  void NormalizeIfLarge();
+
+ public:
+  BigRational();
+  BigRational(int64_t);                                   // NOLINT
+  BigRational(const BigInteger &);                        // NOLINT
+  BigRational(const BigInteger &, const BigInteger &);
+
+  BigInteger Numerator() const;
+  BigInteger Denominator() const;
+  bool IsNegative() const;
+  friend BigRational Abs(const BigRational &);
+
+  BigRational operator+() const;
+  BigRational operator-() const;
+
+  friend BigRational operator+(const BigRational &, const BigRational &);
+  friend BigRational operator-(const BigRational &, const BigRational &);
+  friend BigRational operator*(const BigRational &, const BigRational &);
+  friend BigRational operator/(const BigRational &, const BigRational &);
+
+  friend BigRational &operator+=(BigRational &, const BigRational &);
+  friend BigRational &operator-=(BigRational &, const BigRational &);
+  friend BigRational &operator*=(BigRational &, const BigRational &);
+  friend BigRational &operator/=(BigRational &, const BigRational &);
+
+  explicit operator bool() const;
+  friend bool operator==(const BigRational &, const BigRational &);
+  friend bool operator!=(const BigRational &, const BigRational &);
+  friend bool operator<(const BigRational &, const BigRational &);
+  friend bool operator>(const BigRational &, const BigRational &);
+  friend bool operator<=(const BigRational &, const BigRational &);
+  friend bool operator>=(const BigRational &, const BigRational &);
+
+  friend std::istream &operator>>(std::istream &, BigRational &);
+  friend std::ostream &operator<<(std::ostream &, const BigRational &);
+};
+
+#endif
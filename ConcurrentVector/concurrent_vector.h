@@ -0,0 +1,236 @@
+#ifndef CONCURRENT_VECTOR_H_
+#define CONCURRENT_VECTOR_H_
+
+#include <stddef.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+#include "../Vector/vector.h"
+
+// Append-only vector for many producers. Storage is a table of segments of doubling size (kFirstSegmentSize,
+// 2 * kFirstSegmentSize, ...) which are never moved, so element addresses stay valid while other threads append.
+// EmplaceBack reserves an index with one fetch_add, constructs the element in place and then publishes it by setting
+// its bit in the ready bitmap stored after the elements of the segment; readers only see elements whose bit is set.
+template<class T>
+class ConcurrentVector {
+ public:
+  ConcurrentVector() {
+  }
+
+  ConcurrentVector(const ConcurrentVector &) = delete;
+  ConcurrentVector &operator=(const ConcurrentVector &) = delete;
+
+  ~ConcurrentVector() {
+    ForEachElement([](size_t, T &element) {
+      element.~T();
+    });
+    for (size_t segment = 0; segment < kSegmentsNumber; ++segment) {
+      unsigned char *block = segments_[segment].load(std::memory_order_acquire);
+      if (block != nullptr) {
+        ::operator delete(block, std::align_val_t(kBlockAlignment));
+      }
+    }
+  }
+
+  void PushBack(const T &element) {
+    EmplaceBack(element);
+  }
+
+  void PushBack(T &&element) {
+    EmplaceBack(std::move(element));
+  }
+
+  template<class... Args>
+  T &EmplaceBack(Args &&... args) {
+    size_t index = size_.fetch_add(1, std::memory_order_relaxed);
+    size_t segment = SegmentIndex(index);
+    size_t offset = index - SegmentBegin(segment);
+    // The producer which reaches the middle of a segment installs the next one, so appends rarely wait for it.
+    if (offset == SegmentSize(segment) / 2 && segment + 1 < kSegmentsNumber) {
+      GetSegment(segment + 1);
+    }
+    unsigned char *block = GetSegment(segment);
+    T *element = new (block + offset * sizeof(T)) T(std::forward<Args>(args)...);
+    Ready(block, segment)[offset / 64].fetch_or(uint64_t(1) << offset % 64, std::memory_order_release);
+    return *element;
+  }
+
+  // Allocates the segments for the first size elements up front, so appends don't wait for them.
+  void Reserve(size_t size) {
+    for (size_t segment = 0; segment < kSegmentsNumber && SegmentBegin(segment) < size; ++segment) {
+      GetSegment(segment);
+    }
+  }
+
+  // Number of reserved indices. Elements which are still being constructed are counted but not published yet.
+  size_t Size() const {
+    return size_.load(std::memory_order_acquire);
+  }
+
+  bool IsPublished(size_t index) const {
+    if (index >= Size()) {
+      return false;
+    }
+    size_t segment = SegmentIndex(index);
+    unsigned char *block = LoadSegment(segment);
+    size_t offset = index - SegmentBegin(segment);
+    return block != nullptr &&
+           (Ready(block, segment)[offset / 64].load(std::memory_order_acquire) >> offset % 64 & 1) != 0;
+  }
+
+  // The element must be published.
+  T &operator[](size_t index) {
+    size_t segment = SegmentIndex(index);
+    return *Element(segments_[segment].load(std::memory_order_acquire), index - SegmentBegin(segment));
+  }
+
+  const T &operator[](size_t index) const {
+    size_t segment = SegmentIndex(index);
+    return *Element(segments_[segment].load(std::memory_order_acquire), index - SegmentBegin(segment));
+  }
+
+  // Calls body(index, element) for every published element; safe to run while other threads append.
+  template<class Body>
+  void ForEach(Body body) {
+    ForEachElement([&body](size_t index, T &element) {
+      body(index, element);
+    });
+  }
+
+  template<class Body>
+  void ForEach(Body body) const {
+    ForEachElement([&body](size_t index, T &element) {
+      body(index, static_cast<const T &>(element));
+    });
+  }
+
+  // Conversions expect all producers to have finished. The rvalue overload moves the elements out.
+  Vector<T> ToVector() const & {
+    Vector<T> vector;
+    vector.Reserve(Size());
+    ForEach([&vector](size_t, const T &element) {
+      vector.PushBack(element);
+    });
+    return vector;
+  }
+
+  Vector<T> ToVector() && {
+    Vector<T> vector;
+    vector.Reserve(Size());
+    ForEach([&vector](size_t, T &element) {
+      vector.PushBack(std::move(element));
+    });
+    return vector;
+  }
+
+ private:
+  static const size_t kFirstSegmentLog = 6;
+  static const size_t kFirstSegmentSize = size_t(1) << kFirstSegmentLog;
+  static const size_t kSegmentsNumber = 64 - kFirstSegmentLog;
+  static const size_t kBlockAlignment = std::max(alignof(T), alignof(std::atomic<uint64_t>));
+
+  std::atomic<size_t> size_{0};
+  // A segment is one block: SegmentSize elements followed by SegmentSize / 64 words of ready bits. Segment sizes are
+  // multiples of 64, so the bitmap starts aligned.
+  std::atomic<unsigned char *> segments_[kSegmentsNumber] = {};
+
+  // Segment k holds indices [kFirstSegmentSize * (2^k - 1), kFirstSegmentSize * (2^(k + 1) - 1)).
+  static size_t SegmentIndex(size_t index) {
+    unsigned long long shifted = index + kFirstSegmentSize;  // NOLINT
+    return 63 - __builtin_clzll(shifted) - kFirstSegmentLog;
+  }
+
+  static size_t SegmentBegin(size_t segment) {
+    return (kFirstSegmentSize << segment) - kFirstSegmentSize;
+  }
+
+  static size_t SegmentSize(size_t segment) {
+    return kFirstSegmentSize << segment;
+  }
+
+  // Marks a segment whose block is being allocated by another thread.
+  static unsigned char *Allocating() {
+    static unsigned char tag;
+    return &tag;
+  }
+
+  static T *Element(unsigned char *block, size_t offset) {
+    return std::launder(reinterpret_cast<T *>(block + offset * sizeof(T)));
+  }
+
+  static std::atomic<uint64_t> *Ready(unsigned char *block, size_t segment) {
+    return std::launder(reinterpret_cast<std::atomic<uint64_t> *>(block + SegmentSize(segment) * sizeof(T)));
+  }
+
+  // The block of an installed segment or nullptr.
+  unsigned char *LoadSegment(size_t segment) const {
+    unsigned char *block = segments_[segment].load(std::memory_order_acquire);
+    return block == Allocating() ? nullptr : block;
+  }
+
+  // The first thread to find a segment missing claims it and allocates the block; the others wait until it is
+  // installed. If the allocation throws the claim is dropped and a waiter retries.
+  unsigned char *GetSegment(size_t segment) {
+    while (true) {
+      unsigned char *block = segments_[segment].load(std::memory_order_acquire);
+      if (block == nullptr) {
+        if (!segments_[segment].compare_exchange_strong(block, Allocating(), std::memory_order_acquire)) {
+          continue;
+        }
+        try {
+          block = AllocateSegment(segment);
+        } catch (...) {
+          segments_[segment].store(nullptr, std::memory_order_release);
+          segments_[segment].notify_all();
+          throw;
+        }
+        segments_[segment].store(block, std::memory_order_release);
+        segments_[segment].notify_all();
+        return block;
+      }
+      if (block != Allocating()) {
+        return block;
+      }
+      segments_[segment].wait(block, std::memory_order_acquire);
+    }
+  }
+
+  static unsigned char *AllocateSegment(size_t segment) {
+    size_t words = SegmentSize(segment) / 64;
+    auto *block = static_cast<unsigned char *>(
+        ::operator new(SegmentSize(segment) * sizeof(T) + words * sizeof(std::atomic<uint64_t>),
+                       std::align_val_t(kBlockAlignment)));
+    auto *ready = reinterpret_cast<std::atomic<uint64_t> *>(block + SegmentSize(segment) * sizeof(T));
+    for (size_t i = 0; i < words; ++i) {
+      new (ready + i) std::atomic<uint64_t>(0);
+    }
+    return block;
+  }
+
+  template<class Body>
+  void ForEachElement(Body body) const {
+    size_t size = Size();
+    for (size_t segment = 0; segment < kSegmentsNumber && SegmentBegin(segment) < size; ++segment) {
+      unsigned char *block = LoadSegment(segment);
+      if (block == nullptr) {
+        continue;
+      }
+      size_t first = SegmentBegin(segment);
+      size_t count = std::min(SegmentSize(segment), size - first);
+      std::atomic<uint64_t> *ready = Ready(block, segment);
+      for (size_t word = 0; word * 64 < count; ++word) {
+        uint64_t bits = ready[word].load(std::memory_order_acquire);
+        while (bits != 0) {
+          size_t offset = word * 64 + __builtin_ctzll(bits);
+          bits &= bits - 1;
+          body(first + offset, *Element(block, offset));
+        }
+      }
+    }
+  }
+};
+
+#endif
@@ -0,0 +1,116 @@
+#ifndef INSTRUMENTATION_H_
+#define INSTRUMENTATION_H_
+
+// Opt-in counters for hot paths. Without CONTAINERS_INSTRUMENTATION every INSTRUMENT_* macro expands to nothing,
+// so instrumented code compiles exactly as before. With it, each macro site looks its counter up once (through a
+// function-local static) and afterwards costs one relaxed atomic addition. Sites inside constexpr functions skip
+// counting during constant evaluation.
+
+#ifdef CONTAINERS_INSTRUMENTATION
+
+#include <stddef.h>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+
+class InstrumentationRegistry {
+ public:
+  static InstrumentationRegistry &Instance() {
+    static InstrumentationRegistry registry;
+    return registry;
+  }
+
+  // Counters live in map nodes, which never move, so the returned reference stays valid.
+  std::atomic<uint64_t> &Counter(const char *type, const char *name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return counters_[type][name];
+  }
+
+  void Reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto &type : counters_) {
+      for (auto &counter : type.second) {
+        counter.second.store(0, std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // {"Type": {"counter": value, ...}, ...}
+  void WriteJson(std::ostream &os) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    os << '{';
+    bool is_first_type = true;
+    for (const auto &type : counters_) {
+      os << (is_first_type ? "" : ",") << "\n  \"" << type.first << "\": {";
+      bool is_first_counter = true;
+      for (const auto &counter : type.second) {
+        os << (is_first_counter ? "" : ", ") << '"' << counter.first << "\": "
+           << counter.second.load(std::memory_order_relaxed);
+        is_first_counter = false;
+      }
+      os << '}';
+      is_first_type = false;
+    }
+    os << "\n}\n";
+  }
+
+ private:
+  std::mutex mutex_;
+  std::map<std::string, std::map<std::string, std::atomic<uint64_t>>> counters_;
+};
+
+constexpr bool InstrumentationIsConstantEvaluated() {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_is_constant_evaluated();
+#else
+  return false;
+#endif
+}
+
+#define INSTRUMENT_ADD(type, name, value)                                                           \
+  do {                                                                                              \
+    struct InstrumentationSite {                                                                    \
+      static std::atomic<uint64_t> &Counter() {                                                     \
+        static std::atomic<uint64_t> &counter = InstrumentationRegistry::Instance().Counter(type, name); \
+        return counter;                                                                             \
+      }                                                                                             \
+    };                                                                                              \
+    if (!InstrumentationIsConstantEvaluated()) {                                                    \
+      InstrumentationSite::Counter().fetch_add(static_cast<uint64_t>(value), std::memory_order_relaxed); \
+    }                                                                                               \
+  } while (false)
+
+#define INSTRUMENT_WRITE_JSON(os) InstrumentationRegistry::Instance().WriteJson(os)
+#define INSTRUMENT_RESET() InstrumentationRegistry::Instance().Reset()
+
+#else
+
+#define INSTRUMENT_ADD(type, name, value) \
+  do {                                    \
+  } while (false)
+
+#define INSTRUMENT_WRITE_JSON(os) \
+  do {                            \
+  } while (false)
+
+#define INSTRUMENT_RESET() \
+  do {                     \
+  } while (false)
+
+#endif
+
+#define INSTRUMENT_CALL(type, operation) INSTRUMENT_ADD(type, operation, 1)
+
+#define INSTRUMENT_ALLOCATION(type, bytes)      \
+  do {                                          \
+    INSTRUMENT_ADD(type, "allocations", 1);     \
+    INSTRUMENT_ADD(type, "bytes_allocated", bytes); \
+  } while (false)
+
+#define INSTRUMENT_COPY(type, bytes) INSTRUMENT_ADD(type, "bytes_copied", bytes)
+
+#endif
@@ -0,0 +1,267 @@
+#ifndef BATCHED_MATRIX_H_
+#define BATCHED_MATRIX_H_
+
+#include <stddef.h>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "matrix.h"
+
+class BatchedMatrixSizeMismatch : public std::invalid_argument {
+ public:
+  BatchedMatrixSizeMismatch() : std::invalid_argument("BatchedMatrixSizeMismatch") {
+  }
+};
+
+// Many matrices of the same shape stored as structure of arrays: element (i, j) of all matrices lies
+// in one contiguous lane, so every batched operation is a loop over lanes which the compiler vectorizes
+// across the batch dimension.
+template<class Number, size_t N, size_t M>
+class BatchedMatrix {
+ public:
+  BatchedMatrix() : size_(0) {
+  }
+
+  explicit BatchedMatrix(size_t size) : size_(size), data_(N * M * size) {
+  }
+
+  size_t Size() const {
+    return size_;
+  }
+
+  size_t RowsNumber() const {
+    return N;
+  }
+
+  size_t ColumnsNumber() const {
+    return M;
+  }
+
+  // Element (i, j) of all matrices of the batch.
+  Number *Lane(size_t i, size_t j) {
+    return data_.data() + (i * M + j) * size_;
+  }
+
+  const Number *Lane(size_t i, size_t j) const {
+    return data_.data() + (i * M + j) * size_;
+  }
+
+  Number &operator()(size_t index, size_t i, size_t j) {
+    return data_[(i * M + j) * size_ + index];
+  }
+
+  const Number &operator()(size_t index, size_t i, size_t j) const {
+    return data_[(i * M + j) * size_ + index];
+  }
+
+  Matrix<Number, N, M> Get(size_t index) const {
+    if (index >= size_) {
+      throw MatrixOutOfRange();
+    }
+    Matrix<Number, N, M> matrix;
+    for (size_t i = 0; i < N; ++i) {
+      for (size_t j = 0; j < M; ++j) {
+        matrix(i, j) = (*this)(index, i, j);
+      }
+    }
+    return matrix;
+  }
+
+  void Set(size_t index, const Matrix<Number, N, M> &matrix) {
+    if (index >= size_) {
+      throw MatrixOutOfRange();
+    }
+    for (size_t i = 0; i < N; ++i) {
+      for (size_t j = 0; j < M; ++j) {
+        (*this)(index, i, j) = matrix(i, j);
+      }
+    }
+  }
+
+  template<size_t K>
+  friend BatchedMatrix<Number, N, K> operator*(const BatchedMatrix<Number, N, M> &left,
+                                               const BatchedMatrix<Number, M, K> &right) {
+    if (left.Size() != right.Size()) {
+      throw BatchedMatrixSizeMismatch();
+    }
+    size_t size = left.Size();
+    BatchedMatrix<Number, N, K> result(size);
+    for (size_t i = 0; i < N; ++i) {
+      for (size_t j = 0; j < K; ++j) {
+        Number *__restrict out = result.Lane(i, j);
+        for (size_t k = 0; k < M; ++k) {
+          const Number *__restrict a = left.Lane(i, k);
+          const Number *__restrict b = right.Lane(k, j);
+          for (size_t t = 0; t < size; ++t) {
+            out[t] += a[t] * b[t];
+          }
+        }
+      }
+    }
+    return result;
+  }
+
+ private:
+  size_t size_;
+  std::vector<Number> data_;
+};
+
+// Applies one matrix, e.g. a transform, to every matrix of the batch.
+template<class Number, size_t N, size_t M, size_t K>
+BatchedMatrix<Number, N, K> operator*(const Matrix<Number, N, M> &left, const BatchedMatrix<Number, M, K> &right) {
+  size_t size = right.Size();
+  BatchedMatrix<Number, N, K> result(size);
+  for (size_t i = 0; i < N; ++i) {
+    for (size_t j = 0; j < K; ++j) {
+      Number *__restrict out = result.Lane(i, j);
+      for (size_t k = 0; k < M; ++k) {
+        const Number a = left(i, k);
+        const Number *__restrict b = right.Lane(k, j);
+        for (size_t t = 0; t < size; ++t) {
+          out[t] += a * b[t];
+        }
+      }
+    }
+  }
+  return result;
+}
+
+template<class Number, size_t N>
+std::vector<Number> Determinant(const BatchedMatrix<Number, N, N> &batch) {
+  static_assert(N >= 1 && N <= 4, "Batched determinant is implemented for matrices up to 4x4");
+  size_t size = batch.Size();
+  std::vector<Number> determinant(size);
+  Number *__restrict out = determinant.data();
+  const Number *a[N][N];
+  for (size_t i = 0; i < N; ++i) {
+    for (size_t j = 0; j < N; ++j) {
+      a[i][j] = batch.Lane(i, j);
+    }
+  }
+
+  if constexpr (N == 1) {
+    for (size_t t = 0; t < size; ++t) {
+      out[t] = a[0][0][t];
+    }
+  } else if constexpr (N == 2) {
+    for (size_t t = 0; t < size; ++t) {
+      out[t] = a[0][0][t] * a[1][1][t] - a[0][1][t] * a[1][0][t];
+    }
+  } else if constexpr (N == 3) {
+    for (size_t t = 0; t < size; ++t) {
+      out[t] = a[0][0][t] * (a[1][1][t] * a[2][2][t] - a[1][2][t] * a[2][1][t]) +
+          a[0][1][t] * (a[1][2][t] * a[2][0][t] - a[1][0][t] * a[2][2][t]) +
+          a[0][2][t] * (a[1][0][t] * a[2][1][t] - a[1][1][t] * a[2][0][t]);
+    }
+  } else {
+    for (size_t t = 0; t < size; ++t) {
+      Number s0 = a[0][0][t] * a[1][1][t] - a[1][0][t] * a[0][1][t];
+      Number s1 = a[0][0][t] * a[1][2][t] - a[1][0][t] * a[0][2][t];
+      Number s2 = a[0][0][t] * a[1][3][t] - a[1][0][t] * a[0][3][t];
+      Number s3 = a[0][1][t] * a[1][2][t] - a[1][1][t] * a[0][2][t];
+      Number s4 = a[0][1][t] * a[1][3][t] - a[1][1][t] * a[0][3][t];
+      Number s5 = a[0][2][t] * a[1][3][t] - a[1][2][t] * a[0][3][t];
+      Number c5 = a[2][2][t] * a[3][3][t] - a[3][2][t] * a[2][3][t];
+      Number c4 = a[2][1][t] * a[3][3][t] - a[3][1][t] * a[2][3][t];
+      Number c3 = a[2][1][t] * a[3][2][t] - a[3][1][t] * a[2][2][t];
+      Number c2 = a[2][0][t] * a[3][3][t] - a[3][0][t] * a[2][3][t];
+      Number c1 = a[2][0][t] * a[3][2][t] - a[3][0][t] * a[2][2][t];
+      Number c0 = a[2][0][t] * a[3][1][t] - a[3][0][t] * a[2][1][t];
+      out[t] = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+    }
+  }
+  return determinant;
+}
+
+// Throws MatrixIsDegenerateError if any matrix of the batch is degenerate. Entries are multiplied by 1 / det,
+// which would truncate to zero for integers, so only floating point batches can be inverted.
+template<class Number, size_t N>
+BatchedMatrix<Number, N, N> GetInversed(const BatchedMatrix<Number, N, N> &batch) {
+  static_assert(N >= 1 && N <= 4, "Batched inverse is implemented for matrices up to 4x4");
+  static_assert(std::is_floating_point<Number>::value, "Batched inverse requires floating point numbers");
+  size_t size = batch.Size();
+  std::vector<Number> determinant = Determinant(batch);
+  for (size_t t = 0; t < size; ++t) {
+    if (determinant[t] == Number()) {
+      throw MatrixIsDegenerateError();
+    }
+  }
+
+  BatchedMatrix<Number, N, N> inversed(size);
+  const Number *a[N][N];
+  Number *b[N][N];
+  for (size_t i = 0; i < N; ++i) {
+    for (size_t j = 0; j < N; ++j) {
+      a[i][j] = batch.Lane(i, j);
+      b[i][j] = inversed.Lane(i, j);
+    }
+  }
+  const Number *det = determinant.data();
+
+  if constexpr (N == 1) {
+    for (size_t t = 0; t < size; ++t) {
+      b[0][0][t] = Number(1) / det[t];
+    }
+  } else if constexpr (N == 2) {
+    for (size_t t = 0; t < size; ++t) {
+      Number inv = Number(1) / det[t];
+      Number a00 = a[0][0][t];
+      Number a01 = a[0][1][t];
+      Number a10 = a[1][0][t];
+      Number a11 = a[1][1][t];
+      b[0][0][t] = a11 * inv;
+      b[0][1][t] = -a01 * inv;
+      b[1][0][t] = -a10 * inv;
+      b[1][1][t] = a00 * inv;
+    }
+  } else if constexpr (N == 3) {
+    for (size_t t = 0; t < size; ++t) {
+      Number inv = Number(1) / det[t];
+      b[0][0][t] = (a[1][1][t] * a[2][2][t] - a[1][2][t] * a[2][1][t]) * inv;
+      b[0][1][t] = (a[0][2][t] * a[2][1][t] - a[0][1][t] * a[2][2][t]) * inv;
+      b[0][2][t] = (a[0][1][t] * a[1][2][t] - a[0][2][t] * a[1][1][t]) * inv;
+      b[1][0][t] = (a[1][2][t] * a[2][0][t] - a[1][0][t] * a[2][2][t]) * inv;
+      b[1][1][t] = (a[0][0][t] * a[2][2][t] - a[0][2][t] * a[2][0][t]) * inv;
+      b[1][2][t] = (a[0][2][t] * a[1][0][t] - a[0][0][t] * a[1][2][t]) * inv;
+      b[2][0][t] = (a[1][0][t] * a[2][1][t] - a[1][1][t] * a[2][0][t]) * inv;
+      b[2][1][t] = (a[0][1][t] * a[2][0][t] - a[0][0][t] * a[2][1][t]) * inv;
+      b[2][2][t] = (a[0][0][t] * a[1][1][t] - a[0][1][t] * a[1][0][t]) * inv;
+    }
+  } else {
+    for (size_t t = 0; t < size; ++t) {
+      Number inv = Number(1) / det[t];
+      Number s0 = a[0][0][t] * a[1][1][t] - a[1][0][t] * a[0][1][t];
+      Number s1 = a[0][0][t] * a[1][2][t] - a[1][0][t] * a[0][2][t];
+      Number s2 = a[0][0][t] * a[1][3][t] - a[1][0][t] * a[0][3][t];
+      Number s3 = a[0][1][t] * a[1][2][t] - a[1][1][t] * a[0][2][t];
+      Number s4 = a[0][1][t] * a[1][3][t] - a[1][1][t] * a[0][3][t];
+      Number s5 = a[0][2][t] * a[1][3][t] - a[1][2][t] * a[0][3][t];
+      Number c5 = a[2][2][t] * a[3][3][t] - a[3][2][t] * a[2][3][t];
+      Number c4 = a[2][1][t] * a[3][3][t] - a[3][1][t] * a[2][3][t];
+      Number c3 = a[2][1][t] * a[3][2][t] - a[3][1][t] * a[2][2][t];
+      Number c2 = a[2][0][t] * a[3][3][t] - a[3][0][t] * a[2][3][t];
+      Number c1 = a[2][0][t] * a[3][2][t] - a[3][0][t] * a[2][2][t];
+      Number c0 = a[2][0][t] * a[3][1][t] - a[3][0][t] * a[2][1][t];
+      b[0][0][t] = (a[1][1][t] * c5 - a[1][2][t] * c4 + a[1][3][t] * c3) * inv;
+      b[0][1][t] = (-a[0][1][t] * c5 + a[0][2][t] * c4 - a[0][3][t] * c3) * inv;
+      b[0][2][t] = (a[3][1][t] * s5 - a[3][2][t] * s4 + a[3][3][t] * s3) * inv;
+      b[0][3][t] = (-a[2][1][t] * s5 + a[2][2][t] * s4 - a[2][3][t] * s3) * inv;
+      b[1][0][t] = (-a[1][0][t] * c5 + a[1][2][t] * c2 - a[1][3][t] * c1) * inv;
+      b[1][1][t] = (a[0][0][t] * c5 - a[0][2][t] * c2 + a[0][3][t] * c1) * inv;
+      b[1][2][t] = (-a[3][0][t] * s5 + a[3][2][t] * s2 - a[3][3][t] * s1) * inv;
+      b[1][3][t] = (a[2][0][t] * s5 - a[2][2][t] * s2 + a[2][3][t] * s1) * inv;
+      b[2][0][t] = (a[1][0][t] * c4 - a[1][1][t] * c2 + a[1][3][t] * c0) * inv;
+      b[2][1][t] = (-a[0][0][t] * c4 + a[0][1][t] * c2 - a[0][3][t] * c0) * inv;
+      b[2][2][t] = (a[3][0][t] * s4 - a[3][1][t] * s2 + a[3][3][t] * s0) * inv;
+      b[2][3][t] = (-a[2][0][t] * s4 + a[2][1][t] * s2 - a[2][3][t] * s0) * inv;
+      b[3][0][t] = (-a[1][0][t] * c3 + a[1][1][t] * c1 - a[1][2][t] * c0) * inv;
+      b[3][1][t] = (a[0][0][t] * c3 - a[0][1][t] * c1 + a[0][2][t] * c0) * inv;
+      b[3][2][t] = (-a[3][0][t] * s3 + a[3][1][t] * s1 - a[3][2][t] * s0) * inv;
+      b[3][3][t] = (a[2][0][t] * s3 - a[2][1][t] * s1 + a[2][2][t] * s0) * inv;
+    }
+  }
+  return inversed;
+}
+
+#endif
@@ -3,7 +3,14 @@
 #define MATRIX_SQUARE_MATRIX_IMPLEMENTED
 
 #include <stddef.h>
+#include <bit>
+#include <cstdint>
+#include <iostream>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "../Instrumentation/instrumentation.h"
 
 class MatrixIsDegenerateError : public std::runtime_error {
  public:
@@ -17,62 +24,267 @@ class MatrixOutOfRange : public std::out_of_range {
   }
 };
 
+class MatrixZeroModulus : public std::invalid_argument {
+ public:
+  MatrixZeroModulus() : std::invalid_argument("MatrixZeroModulus") {
+  }
+};
+
+template<class Number, size_t N, size_t M>
+class Matrix;
+
+template<class T>
+struct IsMatrix : std::false_type {
+};
+
+template<class Number, size_t N, size_t M>
+struct IsMatrix<Matrix<Number, N, M>> : std::true_type {
+};
+
+// Elementwise operations build lazy expressions which are evaluated in a single pass when they are assigned
+// to a Matrix. Matrices are captured by reference, so an expression must not outlive its operands.
+template<class T>
+struct IsMatrixExpression : IsMatrix<T> {
+};
+
+template<class Expression>
+struct MatrixExpressionOperand {
+  using Type = const Expression;
+};
+
+template<class Number, size_t N, size_t M>
+struct MatrixExpressionOperand<Matrix<Number, N, M>> {
+  using Type = const Matrix<Number, N, M> &;
+};
+
+struct MatrixPlus {
+  template<class Number>
+  static constexpr Number Apply(const Number &left, const Number &right) {
+    return left + right;
+  }
+};
+
+struct MatrixMinus {
+  template<class Number>
+  static constexpr Number Apply(const Number &left, const Number &right) {
+    return left - right;
+  }
+};
+
+struct MatrixMultiplies {
+  template<class Number>
+  static constexpr Number Apply(const Number &left, const int right) {
+    return left * right;
+  }
+};
+
+struct MatrixDivides {
+  template<class Number>
+  static constexpr Number Apply(const Number &left, const int right) {
+    return left / right;
+  }
+};
+
+template<class Left, class Right, class Operation>
+class MatrixElementwiseExpression {
+ public:
+  using NumberType = typename Left::NumberType;
+  static constexpr size_t kRows = Left::kRows;
+  static constexpr size_t kColumns = Left::kColumns;
+
+  static_assert(std::is_same<NumberType, typename Right::NumberType>::value, "Matrix number types do not match");
+  static_assert(kRows == Right::kRows && kColumns == Right::kColumns, "Matrix sizes do not match");
+
+  constexpr MatrixElementwiseExpression(const Left &left, const Right &right) : left_(left), right_(right) {
+  }
+
+  constexpr size_t RowsNumber() const {
+    return kRows;
+  }
+
+  constexpr size_t ColumnsNumber() const {
+    return kColumns;
+  }
+
+  constexpr NumberType operator()(size_t i, size_t j) const {
+    return Operation::Apply(left_(i, j), right_(i, j));
+  }
+
+  constexpr operator Matrix<NumberType, kRows, kColumns>() const {  // NOLINT
+    Matrix<NumberType, kRows, kColumns> result;
+    result = *this;
+    return result;
+  }
+
+ private:
+  typename MatrixExpressionOperand<Left>::Type left_;
+  typename MatrixExpressionOperand<Right>::Type right_;
+};
+
+template<class Expression, class Operation>
+class MatrixScalarExpression {
+ public:
+  using NumberType = typename Expression::NumberType;
+  static constexpr size_t kRows = Expression::kRows;
+  static constexpr size_t kColumns = Expression::kColumns;
+
+  constexpr MatrixScalarExpression(const Expression &expression, const int n) : expression_(expression), n_(n) {
+  }
+
+  constexpr size_t RowsNumber() const {
+    return kRows;
+  }
+
+  constexpr size_t ColumnsNumber() const {
+    return kColumns;
+  }
+
+  constexpr NumberType operator()(size_t i, size_t j) const {
+    return Operation::Apply(expression_(i, j), n_);
+  }
+
+  constexpr operator Matrix<NumberType, kRows, kColumns>() const {  // NOLINT
+    Matrix<NumberType, kRows, kColumns> result;
+    result = *this;
+    return result;
+  }
+
+ private:
+  typename MatrixExpressionOperand<Expression>::Type expression_;
+  int n_;
+};
+
+template<class Left, class Right, class Operation>
+struct IsMatrixExpression<MatrixElementwiseExpression<Left, Right, Operation>> : std::true_type {
+};
+
+template<class Expression, class Operation>
+struct IsMatrixExpression<MatrixScalarExpression<Expression, Operation>> : std::true_type {
+};
+
+template<class Left, class Right>
+using EnableIfMatrixExpressions =
+    std::enable_if_t<IsMatrixExpression<Left>::value && IsMatrixExpression<Right>::value>;
+
+template<class Expression>
+using EnableIfLazyMatrixExpression =
+    std::enable_if_t<IsMatrixExpression<Expression>::value && !IsMatrix<Expression>::value>;
+
+// Matrices up to kUnrolledMatrixSize x kUnrolledMatrixSize use specializations whose index sequences are expanded
+// at compile time, so small fixed-size operations become straight-line code without loops.
+const size_t kUnrolledMatrixSize = 4;
+
+template<size_t N, size_t M, bool = (N <= kUnrolledMatrixSize && M <= kUnrolledMatrixSize)>
+struct MatrixAssignKernel {
+  template<class Target, class Expression>
+  static constexpr void Assign(Target &target, const Expression &expression) {
+    for (size_t i = 0; i < N; ++i) {
+      for (size_t j = 0; j < M; ++j) {
+        target(i, j) = expression(i, j);
+      }
+    }
+  }
+};
+
+template<size_t N, size_t M>
+struct MatrixAssignKernel<N, M, true> {
+  template<class Target, class Expression>
+  static constexpr void Assign(Target &target, const Expression &expression) {
+    Assign(target, expression, std::make_index_sequence<N * M>());
+  }
+
+  template<class Target, class Expression, size_t... Indices>
+  static constexpr void Assign(Target &target, const Expression &expression, std::index_sequence<Indices...>) {
+    (void(target(Indices / M, Indices % M) = expression(Indices / M, Indices % M)), ...);
+  }
+};
+
+template<size_t N, size_t M, size_t K,
+    bool = (N <= kUnrolledMatrixSize && M <= kUnrolledMatrixSize && K <= kUnrolledMatrixSize)>
+struct MatrixProductKernel {
+  template<class Result, class Left, class Right>
+  static constexpr void Multiply(Result &result, const Left &left, const Right &right) {
+    using Number = typename Left::NumberType;
+    for (size_t i = 0; i < N; ++i) {
+      for (size_t j = 0; j < K; ++j) {
+        result(i, j) = Number();
+        for (size_t l = 0; l < M; ++l) {
+          result(i, j) += left(i, l) * right(l, j);
+        }
+      }
+    }
+  }
+};
+
+template<size_t N, size_t M, size_t K>
+struct MatrixProductKernel<N, M, K, true> {
+  template<class Result, class Left, class Right>
+  static constexpr void Multiply(Result &result, const Left &left, const Right &right) {
+    Multiply(result, left, right, std::make_index_sequence<N * K>());
+  }
+
+  template<class Result, class Left, class Right, size_t... Indices>
+  static constexpr void Multiply(Result &result, const Left &left, const Right &right,
+                                 std::index_sequence<Indices...>) {
+    (void(result(Indices / K, Indices % K) =
+        Dot<Indices / K, Indices % K>(left, right, std::make_index_sequence<M>())), ...);
+  }
+
+  template<size_t I, size_t J, class Left, class Right, size_t... Ls>
+  static constexpr typename Left::NumberType Dot(const Left &left, const Right &right, std::index_sequence<Ls...>) {
+    return (... + (left(I, Ls) * right(Ls, J)));
+  }
+};
+
 template<class Number, size_t N, size_t M>
 class Matrix {
   public:
+  using NumberType = Number;
+  static constexpr size_t kRows = N;
+  static constexpr size_t kColumns = M;
+
   Number matrix[N][M];
 
-  size_t RowsNumber() const {
+  constexpr size_t RowsNumber() const {
     return N;
   }
 
-  size_t ColumnsNumber() const {
+  constexpr size_t ColumnsNumber() const {
     return M;
   }
 
-  Number &operator()(size_t i, size_t j) {
+  constexpr Number &operator()(size_t i, size_t j) {
     return matrix[i][j];
   }
 
-  const Number &operator()(size_t i, size_t j) const {
+  constexpr const Number &operator()(size_t i, size_t j) const {
     return matrix[i][j];
   }
 
-  Number &At(size_t i, size_t j) {
+  constexpr Number &At(size_t i, size_t j) {
     if (i < N && j < M) {
       return matrix[i][j];
     }
     throw MatrixOutOfRange();
   }
 
-  const Number &At(size_t i, size_t j) const {
+  constexpr const Number &At(size_t i, size_t j) const {
     if (i < N && j < M) {
       return matrix[i][j];
     }
     throw MatrixOutOfRange();
   }
 
-  friend Matrix<Number, N, M> operator+(const Matrix<Number, N, M> &left, const Matrix<Number, N, M> &right) {
-    Matrix<Number, N, M> result;
-    for (size_t i = 0; i < N; ++i) {
-      for (size_t j = 0; j < M; ++j) {
-        result(i, j) = left(i, j) + right(i, j);
-      }
-    }
-    return result;
-  }
-
-  friend Matrix<Number, N, M> operator-(const Matrix<Number, N, M> &left, const Matrix<Number, N, M> &right) {
-    Matrix<Number, N, M> result;
-    for (size_t i = 0; i < N; ++i) {
-      for (size_t j = 0; j < M; ++j) {
-        result(i, j) = left(i, j) - right(i, j);
-      }
-    }
-    return result;
+  template<class Expression, class = std::enable_if_t<IsMatrixExpression<Expression>::value>>
+  constexpr Matrix &operator=(const Expression &expression) {
+    static_assert(Expression::kRows == N && Expression::kColumns == M, "Matrix sizes do not match");
+    MatrixAssignKernel<N, M>::Assign(*this, expression);
+    return *this;
   }
 
-  friend Matrix<Number, N, M> &operator+=(Matrix<Number, N, M> &left, const Matrix<Number, N, M> &right) {
+  template<class Expression, class = std::enable_if_t<IsMatrixExpression<Expression>::value>>
+  friend constexpr Matrix<Number, N, M> &operator+=(Matrix<Number, N, M> &left, const Expression &right) {
+    static_assert(Expression::kRows == N && Expression::kColumns == M, "Matrix sizes do not match");
     for (size_t i = 0; i < N; ++i) {
       for (size_t j = 0; j < M; ++j) {
         left(i, j) += right(i, j);
@@ -81,7 +293,9 @@ class Matrix {
     return left;
   }
 
-  friend Matrix<Number, N, M> &operator-=(Matrix<Number, N, M> &left, const Matrix<Number, N, M> &right) {
+  template<class Expression, class = std::enable_if_t<IsMatrixExpression<Expression>::value>>
+  friend constexpr Matrix<Number, N, M> &operator-=(Matrix<Number, N, M> &left, const Expression &right) {
+    static_assert(Expression::kRows == N && Expression::kColumns == M, "Matrix sizes do not match");
     for (size_t i = 0; i < N; ++i) {
       for (size_t j = 0; j < M; ++j) {
         left(i, j) -= right(i, j);
@@ -90,28 +304,14 @@ class Matrix {
     return left;
   }
 
-  template<size_t K>
-  friend Matrix<Number, N, K> operator*(const Matrix<Number, N, M> &left, const Matrix<Number, M, K> &right) {
-    Matrix<Number, N, K> result;
-    for (size_t i = 0; i < N; ++i) {
-      for (size_t j = 0; j < K; ++j) {
-        result(i, j) = Number();
-        for (size_t k = 0; k < M; ++k) {
-          result(i, j) += left(i, k) * right(k, j);
-        }
-      }
-    }
-    return result;
-  }
-
-  template<size_t K>
-  friend Matrix<Number, N, K> &operator*=(Matrix<Number, N, M> &left, const Matrix<Number, M, K> &right) {
-    Matrix<Number, N, K> result = left * right;
+  template<class Expression, class = std::enable_if_t<IsMatrixExpression<Expression>::value>>
+  friend constexpr Matrix<Number, N, M> &operator*=(Matrix<Number, N, M> &left, const Expression &right) {
+    Matrix<Number, N, M> result = left * right;
     left = result;
     return left;
   }
 
-  friend Matrix<Number, N, M> &operator*=(Matrix<Number, N, M> &matrix, const int n) {
+  friend constexpr Matrix<Number, N, M> &operator*=(Matrix<Number, N, M> &matrix, const int n) {
     for (size_t i = 0; i < N; ++i) {
       for (size_t j = 0; j < M; ++j) {
         matrix(i, j) *= n;
@@ -120,48 +320,20 @@ class Matrix {
     return matrix;
   }
 
-  friend Matrix<Number, N, M> &operator*=(const int n, Matrix<Number, N, M> &matrix) {
+  friend constexpr Matrix<Number, N, M> &operator*=(const int n, Matrix<Number, N, M> &matrix) {
     return matrix *= n;
   }
 
-  friend Matrix<Number, N, M> operator*(const Matrix<Number, N, M> &matrix, const int n) {
-    Matrix<Number, N, M> result;
-    for (size_t i = 0; i < N; ++i) {
-      for (size_t j = 0; j < M; ++j) {
-        result(i, j) = matrix(i, j) * n;
-      }
-    }
-    return result;
-  }
-
-  friend Matrix<Number, N, M> operator*(const int n, const Matrix<Number, N, M> &matrix) {
-    return matrix * n;
-  }
-
-  friend Matrix<Number, N, M> operator/(const Matrix<Number, N, M> &matrix, const int n) {
-    Matrix<Number, N, M> result;
-    for (size_t i = 0; i < N; ++i) {
-      for (size_t j = 0; j < M; ++j) {
-        result(i, j) = matrix(i, j) / n;
-      }
-    }
-    return result;
-  }
-
-  friend Matrix<Number, N, M> operator/(const int n, const Matrix<Number, N, M> &matrix) {
-    return matrix / n;
-  }
-
-  friend Matrix<Number, N, M> &operator/=(Matrix<Number, N, M> &matrix, const int n) {
+  friend constexpr Matrix<Number, N, M> &operator/=(Matrix<Number, N, M> &matrix, const int n) {
     matrix = matrix / n;
     return matrix;
   }
 
-  friend Matrix<Number, N, M> &operator/=(const int n, Matrix<Number, N, M> &matrix) {
+  friend constexpr Matrix<Number, N, M> &operator/=(const int n, Matrix<Number, N, M> &matrix) {
     return matrix /= n;
   }
 
-  friend bool operator==(const Matrix<Number, N, M> &left, const Matrix<Number, N, M> &right) {
+  friend constexpr bool operator==(const Matrix<Number, N, M> &left, const Matrix<Number, N, M> &right) {
     for (size_t i = 0; i < N; ++i) {
       for (size_t j = 0; j < M; ++j) {
         if (left(i, j) != right(i, j)) {
@@ -172,7 +344,7 @@ class Matrix {
     return true;
   }
 
-  friend bool operator!=(const Matrix<Number, N, M> &left, const Matrix<Number, N, M> &right) {
+  friend constexpr bool operator!=(const Matrix<Number, N, M> &left, const Matrix<Number, N, M> &right) {
     for (size_t i = 0; i < N; ++i) {
       for (size_t j = 0; j < M; ++j) {
         if (left(i, j) != right(i, j)) {
@@ -208,100 +380,1053 @@ class Matrix {
 };
 
 template<class Number, size_t N, size_t M>
-Matrix<Number, M, N> GetTransposed(const Matrix<Number, N, M> &matrix) {
-  Matrix<Number, M, N> transposed;
-  for (size_t i = 0; i < M; ++i) {
-    for (size_t j = 0; j < N; ++j) {
-      transposed(i, j) = matrix(j, i);
-    }
-  }
-  return transposed;
+constexpr const Matrix<Number, N, M> &Evaluate(const Matrix<Number, N, M> &matrix) {
+  return matrix;
 }
 
-template<class Number, size_t N, size_t M>
-Matrix<Number, N, M> &Transpose(Matrix<Number, N, M> &matrix) {
-  matrix = GetTransposed(matrix);
-  return matrix;
+template<class Expression, class = EnableIfLazyMatrixExpression<Expression>>
+constexpr Matrix<typename Expression::NumberType, Expression::kRows, Expression::kColumns> Evaluate(
+    const Expression &expression) {
+  return expression;
 }
 
-template<class Number, size_t N>
-Number Trace(Matrix<Number, N, N> &matrix) {
-  Number trace = Number();
-  for (size_t i = 0; i < N; ++i) {
-    trace += matrix(i, i);
-  }
-  return trace;
+template<class Left, class Right, class = EnableIfMatrixExpressions<Left, Right>>
+constexpr MatrixElementwiseExpression<Left, Right, MatrixPlus> operator+(const Left &left, const Right &right) {
+  return MatrixElementwiseExpression<Left, Right, MatrixPlus>(left, right);
 }
 
-template<class Number, size_t N>
-Matrix<Number, N - 1, N - 1> GetAlgebraicAddition(const Matrix<Number, N, N> &matrix, size_t row, size_t column) {
-  Matrix<Number, N - 1, N - 1> addition;
-  size_t addition_row = 0;
-  size_t addition_col = 0;
-  for (size_t i = 0; i < N; ++i) {
-    if (i == row) {
-      continue;
-    }
-    addition_col = 0;
-    for (size_t j = 0; j < N; ++j) {
-      if (j == column) {
-        continue;
+template<class Left, class Right, class = EnableIfMatrixExpressions<Left, Right>>
+constexpr MatrixElementwiseExpression<Left, Right, MatrixMinus> operator-(const Left &left, const Right &right) {
+  return MatrixElementwiseExpression<Left, Right, MatrixMinus>(left, right);
+}
+
+template<class Expression, class = std::enable_if_t<IsMatrixExpression<Expression>::value>>
+constexpr MatrixScalarExpression<Expression, MatrixMultiplies> operator*(const Expression &matrix, const int n) {
+  return MatrixScalarExpression<Expression, MatrixMultiplies>(matrix, n);
+}
+
+template<class Expression, class = std::enable_if_t<IsMatrixExpression<Expression>::value>>
+constexpr MatrixScalarExpression<Expression, MatrixMultiplies> operator*(const int n, const Expression &matrix) {
+  return matrix * n;
+}
+
+template<class Expression, class = std::enable_if_t<IsMatrixExpression<Expression>::value>>
+constexpr MatrixScalarExpression<Expression, MatrixDivides> operator/(const Expression &matrix, const int n) {
+  return MatrixScalarExpression<Expression, MatrixDivides>(matrix, n);
+}
+
+template<class Expression, class = std::enable_if_t<IsMatrixExpression<Expression>::value>>
+constexpr MatrixScalarExpression<Expression, MatrixDivides> operator/(const int n, const Expression &matrix) {
+  return matrix / n;
+}
+
+// Products are not lazy: lazy operands are evaluated once and the result is materialized.
+template<class Left, class Right, class = EnableIfMatrixExpressions<Left, Right>>
+constexpr Matrix<typename Left::NumberType, Left::kRows, Right::kColumns> operator*(const Left &left_expression,
+                                                                                    const Right &right_expression) {
+  static_assert(std::is_same<typename Left::NumberType, typename Right::NumberType>::value,
+                "Matrix number types do not match");
+  static_assert(Left::kColumns == Right::kRows, "Matrix sizes do not match");
+  using Number = typename Left::NumberType;
+  const size_t n = Left::kRows;
+  const size_t m = Left::kColumns;
+  const size_t k = Right::kColumns;
+
+  INSTRUMENT_CALL("Matrix", "operator*");
+  const auto &left = Evaluate(left_expression);
+  const auto &right = Evaluate(right_expression);
+  Matrix<Number, n, k> result;
+  MatrixProductKernel<n, m, k>::Multiply(result, left, right);
+  return result;
+}
+
+template<class Left, class Right, class = EnableIfMatrixExpressions<Left, Right>,
+    class = std::enable_if_t<!IsMatrix<Left>::value || !IsMatrix<Right>::value>>
+constexpr bool operator==(const Left &left, const Right &right) {
+  static_assert(Left::kRows == Right::kRows && Left::kColumns == Right::kColumns, "Matrix sizes do not match");
+  for (size_t i = 0; i < Left::kRows; ++i) {
+    for (size_t j = 0; j < Left::kColumns; ++j) {
+      if (left(i, j) != right(i, j)) {
+        return false;
       }
-      addition(addition_row, addition_col) = matrix(i, j) * ((i + j) % 2 == 0 ? 1 : -1);
-      ++addition_col;
     }
-    ++addition_row;
   }
-  return addition;
+  return true;
 }
 
-template<class Number>
-Number Determinant(const Matrix<Number, 1, 1> &matrix) {
-  return matrix(0, 0);
+template<class Left, class Right, class = EnableIfMatrixExpressions<Left, Right>,
+    class = std::enable_if_t<!IsMatrix<Left>::value || !IsMatrix<Right>::value>>
+constexpr bool operator!=(const Left &left, const Right &right) {
+  return !(left == right);
 }
 
-template<class Number, size_t N>
-Number Determinant(const Matrix<Number, N, N> &matrix) {
-  Number determinant = Number();
-  for (size_t j = 0; j < N; ++j) {
-    Matrix<Number, N - 1, N - 1> addition = GetAlgebraicAddition(matrix, 0, j);
-    determinant +=  matrix(0, j) * Determinant(addition);
+// Layouts address the elements of a view. A block, row or column of a matrix is the parent's row array, the first
+// row and the first column: row stride Width, column stride 1, nothing copied. Minors skip a row and a column,
+// so they keep a pointer per row and an offset per column; blocks and minors of minors stay indexed.
+template<class Element, size_t Width>
+struct MatrixBlockLayout {
+  using ConstLayout = MatrixBlockLayout<const Element, Width>;
+
+  Element (*rows)[Width];
+  size_t column;
+
+  constexpr Element &operator()(size_t i, size_t j) const {
+    return rows[i][column + j];
   }
 
-  return determinant;
-}
+  constexpr Element *RowPointer(size_t i) const {
+    return rows[i] + column;
+  }
 
-template<class Number>
-Matrix<Number, 1, 1> GetInversed(const Matrix<Number, 1, 1> &matrix) {
-  if (matrix(0, 0) == 0) {
-    throw MatrixIsDegenerateError();
+  constexpr size_t ColumnOffset(size_t j) const {
+    return j;
   }
-  Matrix<Number, 1, 1> inversed;
-  inversed(0, 0) = 1 / matrix(0, 0);
-  return inversed;
-}
 
-template<class Number, size_t N>
-Matrix<Number, N, N> GetInversed(const Matrix<Number, N, N> &matrix) {
-  Number determinant = Determinant(matrix);
-  if (determinant == 0) {
-    throw MatrixIsDegenerateError();
+  template<size_t R, size_t C>
+  constexpr MatrixBlockLayout Block(size_t row, size_t first_column) const {
+    return MatrixBlockLayout{rows + row, column + first_column};
   }
 
-  Matrix<Number, N, N> inversed;
-  for (size_t i = 0; i < N; ++i) {
-    for (size_t j = 0; j < N; ++j) {
-      inversed(i, j) = Determinant(GetAlgebraicAddition(matrix, i, j)) / (determinant);
+  constexpr ConstLayout ToConst() const {
+    return ConstLayout{rows, column};
+  }
+};
+
+template<class Element, size_t N, size_t M>
+struct MatrixIndexedLayout {
+  using ConstLayout = MatrixIndexedLayout<const Element, N, M>;
+
+  Element *rows[N];
+  size_t columns[M];
+
+  constexpr Element &operator()(size_t i, size_t j) const {
+    return rows[i][columns[j]];
+  }
+
+  constexpr Element *RowPointer(size_t i) const {
+    return rows[i];
+  }
+
+  constexpr size_t ColumnOffset(size_t j) const {
+    return columns[j];
+  }
+
+  template<size_t R, size_t C>
+  constexpr MatrixIndexedLayout<Element, R, C> Block(size_t row, size_t column) const {
+    MatrixIndexedLayout<Element, R, C> block{};
+    for (size_t i = 0; i < R; ++i) {
+      block.rows[i] = rows[row + i];
+    }
+    for (size_t j = 0; j < C; ++j) {
+      block.columns[j] = columns[column + j];
     }
+    return block;
   }
-  inversed = GetTransposed(inversed);
-  return inversed;
-}
 
-template<class Number, size_t N>
-Matrix<Number, N, N> &Inverse(Matrix<Number, N, N> &matrix) {
-  matrix = GetInversed(matrix);
-  return matrix;
+  constexpr ConstLayout ToConst() const {
+    ConstLayout layout{};
+    for (size_t i = 0; i < N; ++i) {
+      layout.rows[i] = rows[i];
+    }
+    for (size_t j = 0; j < M; ++j) {
+      layout.columns[j] = columns[j];
+    }
+    return layout;
+  }
+
+  template<class Layout>
+  static constexpr MatrixIndexedLayout Minor(const Layout &layout, size_t row, size_t column) {
+    MatrixIndexedLayout minor{};
+    for (size_t i = 0; i < N; ++i) {
+      minor.rows[i] = layout.RowPointer(i < row ? i : i + 1);
+    }
+    for (size_t j = 0; j < M; ++j) {
+      minor.columns[j] = layout.ColumnOffset(j < column ? j : j + 1);
+    }
+    return minor;
+  }
+};
+
+// Views share storage with their parent matrix, so cofactor expansions never copy elements.
+// Assigning between overlapping views of the same matrix has to go through a Matrix temporary.
+template<class Number, size_t N, size_t M, class Layout = MatrixBlockLayout<const Number, M>>
+class ConstMatrixView {
+ public:
+  using NumberType = Number;
+  static constexpr size_t kRows = N;
+  static constexpr size_t kColumns = M;
+
+  explicit constexpr ConstMatrixView(const Layout &layout) : layout_(layout) {
+  }
+
+  constexpr size_t RowsNumber() const {
+    return N;
+  }
+
+  constexpr size_t ColumnsNumber() const {
+    return M;
+  }
+
+  constexpr const Number &operator()(size_t i, size_t j) const {
+    return layout_(i, j);
+  }
+
+  constexpr const Number &At(size_t i, size_t j) const {
+    if (i < N && j < M) {
+      return (*this)(i, j);
+    }
+    throw MatrixOutOfRange();
+  }
+
+  template<size_t R, size_t C>
+  constexpr auto Block(size_t row, size_t column) const {
+    if (row + R > N || column + C > M) {
+      throw MatrixOutOfRange();
+    }
+    auto block = layout_.template Block<R, C>(row, column);
+    return ConstMatrixView<Number, R, C, decltype(block)>(block);
+  }
+
+  constexpr auto Row(size_t i) const {
+    return Block<1, M>(i, 0);
+  }
+
+  constexpr auto Column(size_t j) const {
+    return Block<N, 1>(0, j);
+  }
+
+  constexpr auto Minor(size_t row, size_t column) const {
+    if (row >= N || column >= M) {
+      throw MatrixOutOfRange();
+    }
+    using MinorLayout = MatrixIndexedLayout<const Number, N - 1, M - 1>;
+    return ConstMatrixView<Number, N - 1, M - 1, MinorLayout>(MinorLayout::Minor(layout_, row, column));
+  }
+
+  constexpr operator Matrix<Number, N, M>() const {  // NOLINT
+    Matrix<Number, N, M> result;
+    result = *this;
+    return result;
+  }
+
+ private:
+  Layout layout_;
+};
+
+template<class Number, size_t N, size_t M, class Layout = MatrixBlockLayout<Number, M>>
+class MatrixView {
+ public:
+  using NumberType = Number;
+  static constexpr size_t kRows = N;
+  static constexpr size_t kColumns = M;
+
+  explicit constexpr MatrixView(const Layout &layout) : layout_(layout) {
+  }
+
+  MatrixView(const MatrixView &) = default;
+
+  // Assignment writes through the view, like assignment to a reference.
+  constexpr MatrixView &operator=(const MatrixView &other) {
+    return *this = ConstMatrixView<Number, N, M, typename Layout::ConstLayout>(other);
+  }
+
+  template<class Expression, class = std::enable_if_t<IsMatrixExpression<Expression>::value>>
+  constexpr MatrixView &operator=(const Expression &expression) {
+    static_assert(Expression::kRows == N && Expression::kColumns == M, "Matrix sizes do not match");
+    MatrixAssignKernel<N, M>::Assign(*this, expression);
+    return *this;
+  }
+
+  template<class Expression, class = std::enable_if_t<IsMatrixExpression<Expression>::value>>
+  constexpr MatrixView &operator+=(const Expression &expression) {
+    static_assert(Expression::kRows == N && Expression::kColumns == M, "Matrix sizes do not match");
+    for (size_t i = 0; i < N; ++i) {
+      for (size_t j = 0; j < M; ++j) {
+        (*this)(i, j) += expression(i, j);
+      }
+    }
+    return *this;
+  }
+
+  template<class Expression, class = std::enable_if_t<IsMatrixExpression<Expression>::value>>
+  constexpr MatrixView &operator-=(const Expression &expression) {
+    static_assert(Expression::kRows == N && Expression::kColumns == M, "Matrix sizes do not match");
+    for (size_t i = 0; i < N; ++i) {
+      for (size_t j = 0; j < M; ++j) {
+        (*this)(i, j) -= expression(i, j);
+      }
+    }
+    return *this;
+  }
+
+  constexpr MatrixView &operator*=(const int n) {
+    for (size_t i = 0; i < N; ++i) {
+      for (size_t j = 0; j < M; ++j) {
+        (*this)(i, j) *= n;
+      }
+    }
+    return *this;
+  }
+
+  constexpr MatrixView &operator/=(const int n) {
+    for (size_t i = 0; i < N; ++i) {
+      for (size_t j = 0; j < M; ++j) {
+        (*this)(i, j) /= n;
+      }
+    }
+    return *this;
+  }
+
+  constexpr size_t RowsNumber() const {
+    return N;
+  }
+
+  constexpr size_t ColumnsNumber() const {
+    return M;
+  }
+
+  constexpr Number &operator()(size_t i, size_t j) const {
+    return layout_(i, j);
+  }
+
+  constexpr Number &At(size_t i, size_t j) const {
+    if (i < N && j < M) {
+      return (*this)(i, j);
+    }
+    throw MatrixOutOfRange();
+  }
+
+  template<size_t R, size_t C>
+  constexpr auto Block(size_t row, size_t column) const {
+    if (row + R > N || column + C > M) {
+      throw MatrixOutOfRange();
+    }
+    auto block = layout_.template Block<R, C>(row, column);
+    return MatrixView<Number, R, C, decltype(block)>(block);
+  }
+
+  constexpr auto Row(size_t i) const {
+    return Block<1, M>(i, 0);
+  }
+
+  constexpr auto Column(size_t j) const {
+    return Block<N, 1>(0, j);
+  }
+
+  constexpr auto Minor(size_t row, size_t column) const {
+    if (row >= N || column >= M) {
+      throw MatrixOutOfRange();
+    }
+    using MinorLayout = MatrixIndexedLayout<Number, N - 1, M - 1>;
+    return MatrixView<Number, N - 1, M - 1, MinorLayout>(MinorLayout::Minor(layout_, row, column));
+  }
+
+  constexpr operator ConstMatrixView<Number, N, M, typename Layout::ConstLayout>() const {  // NOLINT
+    return ConstMatrixView<Number, N, M, typename Layout::ConstLayout>(layout_.ToConst());
+  }
+
+  constexpr operator Matrix<Number, N, M>() const {  // NOLINT
+    Matrix<Number, N, M> result;
+    result = *this;
+    return result;
+  }
+
+ private:
+  Layout layout_;
+};
+
+template<class Number, size_t N, size_t M, class Layout>
+struct IsMatrixExpression<ConstMatrixView<Number, N, M, Layout>> : std::true_type {
+};
+
+template<class Number, size_t N, size_t M, class Layout>
+struct IsMatrixExpression<MatrixView<Number, N, M, Layout>> : std::true_type {
+};
+
+template<class Number, size_t N, size_t M>
+constexpr MatrixView<Number, N, M> GetView(Matrix<Number, N, M> &matrix) {
+  return MatrixView<Number, N, M>(MatrixBlockLayout<Number, M>{matrix.matrix, 0});
+}
+
+template<class Number, size_t N, size_t M>
+constexpr ConstMatrixView<Number, N, M> GetView(const Matrix<Number, N, M> &matrix) {
+  return ConstMatrixView<Number, N, M>(MatrixBlockLayout<const Number, M>{matrix.matrix, 0});
+}
+
+template<class Number, size_t N, size_t M, class Layout>
+constexpr MatrixView<Number, N, M, Layout> GetView(const MatrixView<Number, N, M, Layout> &view) {
+  return view;
+}
+
+template<class Number, size_t N, size_t M, class Layout>
+constexpr ConstMatrixView<Number, N, M, Layout> GetView(const ConstMatrixView<Number, N, M, Layout> &view) {
+  return view;
+}
+
+template<size_t R, size_t C, class Number, size_t N, size_t M>
+constexpr auto GetBlock(Matrix<Number, N, M> &matrix, size_t row, size_t column) {
+  return GetView(matrix).template Block<R, C>(row, column);
+}
+
+template<size_t R, size_t C, class Number, size_t N, size_t M>
+constexpr auto GetBlock(const Matrix<Number, N, M> &matrix, size_t row, size_t column) {
+  return GetView(matrix).template Block<R, C>(row, column);
+}
+
+template<class Number, size_t N, size_t M>
+constexpr auto GetRow(Matrix<Number, N, M> &matrix, size_t i) {
+  return GetView(matrix).Row(i);
+}
+
+template<class Number, size_t N, size_t M>
+constexpr auto GetRow(const Matrix<Number, N, M> &matrix, size_t i) {
+  return GetView(matrix).Row(i);
+}
+
+template<class Number, size_t N, size_t M>
+constexpr auto GetColumn(Matrix<Number, N, M> &matrix, size_t j) {
+  return GetView(matrix).Column(j);
+}
+
+template<class Number, size_t N, size_t M>
+constexpr auto GetColumn(const Matrix<Number, N, M> &matrix, size_t j) {
+  return GetView(matrix).Column(j);
+}
+
+template<class Number, size_t N, size_t M>
+constexpr auto GetMinor(Matrix<Number, N, M> &matrix, size_t row, size_t column) {
+  return GetView(matrix).Minor(row, column);
+}
+
+template<class Number, size_t N, size_t M>
+constexpr auto GetMinor(const Matrix<Number, N, M> &matrix, size_t row, size_t column) {
+  return GetView(matrix).Minor(row, column);
+}
+
+template<class Expression, class = EnableIfLazyMatrixExpression<Expression>>
+std::ostream &operator<<(std::ostream &os, const Expression &expression) {
+  return os << Evaluate(expression);
+}
+
+// Transposes are cache-oblivious: blocks are halved along the longer side until they fit in a tile,
+// so both the read and the write side stay in cache for any matrix and cache size.
+const size_t kTransposeTileSize = 16;
+
+template<class Number, size_t N, size_t M>
+constexpr void TransposeBlock(const Matrix<Number, N, M> &matrix, Matrix<Number, M, N> &transposed, size_t row,
+                              size_t column, size_t rows, size_t columns) {
+  if (rows <= kTransposeTileSize && columns <= kTransposeTileSize) {
+    for (size_t i = row; i < row + rows; ++i) {
+      for (size_t j = column; j < column + columns; ++j) {
+        transposed(j, i) = matrix(i, j);
+      }
+    }
+  } else if (rows >= columns) {
+    TransposeBlock(matrix, transposed, row, column, rows / 2, columns);
+    TransposeBlock(matrix, transposed, row + rows / 2, column, rows - rows / 2, columns);
+  } else {
+    TransposeBlock(matrix, transposed, row, column, rows, columns / 2);
+    TransposeBlock(matrix, transposed, row, column + columns / 2, rows, columns - columns / 2);
+  }
+}
+
+// Swaps the block [row, row + rows) x [column, column + columns), which lies above the diagonal,
+// with its mirror below the diagonal.
+template<class Number, size_t N>
+constexpr void SwapTransposedBlocks(Matrix<Number, N, N> &matrix, size_t row, size_t column, size_t rows,
+                                    size_t columns) {
+  if (rows <= kTransposeTileSize && columns <= kTransposeTileSize) {
+    for (size_t i = row; i < row + rows; ++i) {
+      for (size_t j = column; j < column + columns; ++j) {
+        std::swap(matrix(i, j), matrix(j, i));
+      }
+    }
+  } else if (rows >= columns) {
+    SwapTransposedBlocks(matrix, row, column, rows / 2, columns);
+    SwapTransposedBlocks(matrix, row + rows / 2, column, rows - rows / 2, columns);
+  } else {
+    SwapTransposedBlocks(matrix, row, column, rows, columns / 2);
+    SwapTransposedBlocks(matrix, row, column + columns / 2, rows, columns - columns / 2);
+  }
+}
+
+template<class Number, size_t N>
+constexpr void TransposeDiagonalBlock(Matrix<Number, N, N> &matrix, size_t begin, size_t size) {
+  if (size <= kTransposeTileSize) {
+    for (size_t i = begin; i < begin + size; ++i) {
+      for (size_t j = i + 1; j < begin + size; ++j) {
+        std::swap(matrix(i, j), matrix(j, i));
+      }
+    }
+    return;
+  }
+  size_t half = size / 2;
+  TransposeDiagonalBlock(matrix, begin, half);
+  TransposeDiagonalBlock(matrix, begin + half, size - half);
+  SwapTransposedBlocks(matrix, begin, begin + half, half, size - half);
+}
+
+template<class Number, size_t N, size_t M>
+constexpr Matrix<Number, M, N> GetTransposed(const Matrix<Number, N, M> &matrix) {
+  Matrix<Number, M, N> transposed;
+  TransposeBlock(matrix, transposed, 0, 0, N, M);
+  return transposed;
+}
+
+template<class Number, size_t N>
+constexpr Matrix<Number, N, N> &Transpose(Matrix<Number, N, N> &matrix) {
+  TransposeDiagonalBlock(matrix, 0, N);
+  return matrix;
+}
+
+template<class Expression, class = EnableIfLazyMatrixExpression<Expression>>
+constexpr auto GetTransposed(const Expression &expression) {
+  return GetTransposed(Evaluate(expression));
+}
+
+template<class Number, size_t N>
+constexpr Number Trace(const Matrix<Number, N, N> &matrix) {
+  Number trace = Number();
+  for (size_t i = 0; i < N; ++i) {
+    trace += matrix(i, i);
+  }
+  return trace;
+}
+
+template<class Number, size_t N, class Layout>
+constexpr Number Trace(const ConstMatrixView<Number, N, N, Layout> &matrix) {
+  Number trace = Number();
+  for (size_t i = 0; i < N; ++i) {
+    trace += matrix(i, i);
+  }
+  return trace;
+}
+
+template<class Number, size_t N, class Layout>
+constexpr Number Trace(const MatrixView<Number, N, N, Layout> &matrix) {
+  return Trace(ConstMatrixView<Number, N, N, typename Layout::ConstLayout>(matrix));
+}
+
+// Accumulation policies for Multiply and Trace. PlainAccumulation sums with += in Number, like operator*;
+// WideAccumulation<Wide> multiplies and sums in a wider type, e.g. float matrices accumulated in double;
+// KahanAccumulation carries a compensation term (Neumaier's variant of Kahan summation, defeated by -ffast-math);
+// PairwiseAccumulation sums in a binary tree, so the rounding error grows as O(log n) instead of O(n).
+// Accumulator<Number, Count> adds at most Count values.
+struct PlainAccumulation {
+  template<class Number, size_t Count>
+  class Accumulator {
+   public:
+    constexpr void AddProduct(const Number &left, const Number &right) {
+      sum_ += left * right;
+    }
+
+    constexpr void Add(const Number &value) {
+      sum_ += value;
+    }
+
+    constexpr Number Result() const {
+      return sum_;
+    }
+
+   private:
+    Number sum_ = Number();
+  };
+};
+
+template<class Wide>
+struct WideAccumulation {
+  template<class Number, size_t Count>
+  class Accumulator {
+   public:
+    constexpr void AddProduct(const Number &left, const Number &right) {
+      sum_ += static_cast<Wide>(left) * static_cast<Wide>(right);
+    }
+
+    constexpr void Add(const Number &value) {
+      sum_ += static_cast<Wide>(value);
+    }
+
+    constexpr Number Result() const {
+      return static_cast<Number>(sum_);
+    }
+
+   private:
+    Wide sum_ = Wide();
+  };
+};
+
+struct KahanAccumulation {
+  template<class Number, size_t Count>
+  class Accumulator {
+   public:
+    constexpr void AddProduct(const Number &left, const Number &right) {
+      Add(left * right);
+    }
+
+    constexpr void Add(const Number &value) {
+      Number sum = sum_ + value;
+      if (Abs(sum_) >= Abs(value)) {
+        compensation_ += (sum_ - sum) + value;
+      } else {
+        compensation_ += (value - sum) + sum_;
+      }
+      sum_ = sum;
+    }
+
+    constexpr Number Result() const {
+      return sum_ + compensation_;
+    }
+
+   private:
+    Number sum_ = Number();
+    Number compensation_ = Number();
+
+    static constexpr Number Abs(const Number &value) {
+      return value < Number() ? Number() - value : value;
+    }
+  };
+};
+
+struct PairwiseAccumulation {
+  template<class Number, size_t Count>
+  class Accumulator {
+   public:
+    constexpr void AddProduct(const Number &left, const Number &right) {
+      Add(left * right);
+    }
+
+    // Partial sums are merged like carries of a binary counter: partial_[level] holds the sum of 2^level values.
+    // Count values need bit_width(Count) levels.
+    constexpr void Add(const Number &value) {
+      Number carry = value;
+      size_t level = 0;
+      for (size_t count = count_; count % 2 == 1; count /= 2) {
+        carry = partial_[level] + carry;
+        ++level;
+      }
+      partial_[level] = carry;
+      ++count_;
+    }
+
+    constexpr Number Result() const {
+      Number sum = Number();
+      for (size_t level = 0; level < kLevels; ++level) {
+        if ((count_ >> level) % 2 == 1) {
+          sum = partial_[level] + sum;
+        }
+      }
+      return sum;
+    }
+
+   private:
+    static constexpr size_t kLevels = Count > 1 ? std::bit_width(Count) : 1;
+
+    Number partial_[kLevels] = {};
+    size_t count_ = 0;
+  };
+};
+
+template<class T>
+struct IsAccumulationPolicy : std::false_type {
+};
+
+template<>
+struct IsAccumulationPolicy<PlainAccumulation> : std::true_type {
+};
+
+template<class Wide>
+struct IsAccumulationPolicy<WideAccumulation<Wide>> : std::true_type {
+};
+
+template<>
+struct IsAccumulationPolicy<KahanAccumulation> : std::true_type {
+};
+
+template<>
+struct IsAccumulationPolicy<PairwiseAccumulation> : std::true_type {
+};
+
+template<class Policy, class Number, size_t N, size_t M, size_t K,
+    class = std::enable_if_t<IsAccumulationPolicy<Policy>::value>>
+constexpr Matrix<Number, N, K> Multiply(Policy, const Matrix<Number, N, M> &left, const Matrix<Number, M, K> &right) {
+  Matrix<Number, N, K> result;
+  for (size_t i = 0; i < N; ++i) {
+    for (size_t j = 0; j < K; ++j) {
+      typename Policy::template Accumulator<Number, M> accumulator;
+      for (size_t k = 0; k < M; ++k) {
+        accumulator.AddProduct(left(i, k), right(k, j));
+      }
+      result(i, j) = accumulator.Result();
+    }
+  }
+  return result;
+}
+
+template<class Policy, class Number, size_t N, class = std::enable_if_t<IsAccumulationPolicy<Policy>::value>>
+constexpr Number Trace(Policy, const Matrix<Number, N, N> &matrix) {
+  typename Policy::template Accumulator<Number, N> accumulator;
+  for (size_t i = 0; i < N; ++i) {
+    accumulator.Add(matrix(i, i));
+  }
+  return accumulator.Result();
+}
+
+template<class Number, size_t N>
+constexpr Matrix<Number, N - 1, N - 1> GetAlgebraicAddition(const Matrix<Number, N, N> &matrix, size_t row,
+                                                            size_t column) {
+  Matrix<Number, N - 1, N - 1> addition;
+  size_t addition_row = 0;
+  size_t addition_col = 0;
+  for (size_t i = 0; i < N; ++i) {
+    if (i == row) {
+      continue;
+    }
+    addition_col = 0;
+    for (size_t j = 0; j < N; ++j) {
+      if (j == column) {
+        continue;
+      }
+      addition(addition_row, addition_col) = matrix(i, j) * ((i + j) % 2 == 0 ? 1 : -1);
+      ++addition_col;
+    }
+    ++addition_row;
+  }
+  return addition;
+}
+
+template<size_t N>
+struct DeterminantKernel {
+  template<class Square>
+  static constexpr typename Square::NumberType Compute(const Square &matrix) {
+    using Number = typename Square::NumberType;
+    auto view = GetView(matrix);
+    Number determinant = Number();
+    for (size_t j = 0; j < N; ++j) {
+      if (j % 2 == 0) {
+        determinant += matrix(0, j) * DeterminantKernel<N - 1>::Compute(view.Minor(0, j));
+      } else {
+        determinant -= matrix(0, j) * DeterminantKernel<N - 1>::Compute(view.Minor(0, j));
+      }
+    }
+    return determinant;
+  }
+};
+
+template<>
+struct DeterminantKernel<1> {
+  template<class Square>
+  static constexpr typename Square::NumberType Compute(const Square &matrix) {
+    return matrix(0, 0);
+  }
+};
+
+template<>
+struct DeterminantKernel<2> {
+  template<class Square>
+  static constexpr typename Square::NumberType Compute(const Square &matrix) {
+    return matrix(0, 0) * matrix(1, 1) - matrix(0, 1) * matrix(1, 0);
+  }
+};
+
+template<>
+struct DeterminantKernel<3> {
+  template<class Square>
+  static constexpr typename Square::NumberType Compute(const Square &matrix) {
+    return matrix(0, 0) * (matrix(1, 1) * matrix(2, 2) - matrix(1, 2) * matrix(2, 1)) -
+        matrix(0, 1) * (matrix(1, 0) * matrix(2, 2) - matrix(1, 2) * matrix(2, 0)) +
+        matrix(0, 2) * (matrix(1, 0) * matrix(2, 1) - matrix(1, 1) * matrix(2, 0));
+  }
+};
+
+// Laplace expansion along the first two rows: products of the 2x2 minors of rows 0, 1 (s) and of rows 2, 3 (c).
+template<>
+struct DeterminantKernel<4> {
+  template<class Square>
+  static constexpr typename Square::NumberType Compute(const Square &matrix) {
+    using Number = typename Square::NumberType;
+    Number s0 = matrix(0, 0) * matrix(1, 1) - matrix(1, 0) * matrix(0, 1);
+    Number s1 = matrix(0, 0) * matrix(1, 2) - matrix(1, 0) * matrix(0, 2);
+    Number s2 = matrix(0, 0) * matrix(1, 3) - matrix(1, 0) * matrix(0, 3);
+    Number s3 = matrix(0, 1) * matrix(1, 2) - matrix(1, 1) * matrix(0, 2);
+    Number s4 = matrix(0, 1) * matrix(1, 3) - matrix(1, 1) * matrix(0, 3);
+    Number s5 = matrix(0, 2) * matrix(1, 3) - matrix(1, 2) * matrix(0, 3);
+    Number c5 = matrix(2, 2) * matrix(3, 3) - matrix(3, 2) * matrix(2, 3);
+    Number c4 = matrix(2, 1) * matrix(3, 3) - matrix(3, 1) * matrix(2, 3);
+    Number c3 = matrix(2, 1) * matrix(3, 2) - matrix(3, 1) * matrix(2, 2);
+    Number c2 = matrix(2, 0) * matrix(3, 3) - matrix(3, 0) * matrix(2, 3);
+    Number c1 = matrix(2, 0) * matrix(3, 2) - matrix(3, 0) * matrix(2, 2);
+    Number c0 = matrix(2, 0) * matrix(3, 1) - matrix(3, 0) * matrix(2, 1);
+    return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+  }
+};
+
+template<class Number, size_t N, class Layout>
+constexpr Number Determinant(const ConstMatrixView<Number, N, N, Layout> &matrix) {
+  return DeterminantKernel<N>::Compute(matrix);
+}
+
+template<class Number, size_t N, class Layout>
+constexpr Number Determinant(const MatrixView<Number, N, N, Layout> &matrix) {
+  return Determinant(ConstMatrixView<Number, N, N, typename Layout::ConstLayout>(matrix));
+}
+
+template<class Number, size_t N>
+constexpr Number Determinant(const Matrix<Number, N, N> &matrix) {
+  INSTRUMENT_CALL("Matrix", "Determinant");
+  return DeterminantKernel<N>::Compute(matrix);
+}
+
+template<class Number>
+constexpr Matrix<Number, 1, 1> GetInversed(const Matrix<Number, 1, 1> &matrix) {
+  INSTRUMENT_CALL("Matrix", "GetInversed");
+  if (matrix(0, 0) == 0) {
+    throw MatrixIsDegenerateError();
+  }
+  Matrix<Number, 1, 1> inversed;
+  inversed(0, 0) = 1 / matrix(0, 0);
+  return inversed;
+}
+
+template<class Number>
+constexpr Matrix<Number, 2, 2> GetInversed(const Matrix<Number, 2, 2> &matrix) {
+  INSTRUMENT_CALL("Matrix", "GetInversed");
+  Number determinant = Determinant(matrix);
+  if (determinant == 0) {
+    throw MatrixIsDegenerateError();
+  }
+  Matrix<Number, 2, 2> inversed;
+  inversed(0, 0) = matrix(1, 1) / determinant;
+  inversed(0, 1) = (Number() - matrix(0, 1)) / determinant;
+  inversed(1, 0) = (Number() - matrix(1, 0)) / determinant;
+  inversed(1, 1) = matrix(0, 0) / determinant;
+  return inversed;
+}
+
+template<class Number>
+constexpr Matrix<Number, 3, 3> GetInversed(const Matrix<Number, 3, 3> &matrix) {
+  INSTRUMENT_CALL("Matrix", "GetInversed");
+  Number determinant = Determinant(matrix);
+  if (determinant == 0) {
+    throw MatrixIsDegenerateError();
+  }
+  Matrix<Number, 3, 3> inversed;
+  inversed(0, 0) = (matrix(1, 1) * matrix(2, 2) - matrix(1, 2) * matrix(2, 1)) / determinant;
+  inversed(0, 1) = (matrix(0, 2) * matrix(2, 1) - matrix(0, 1) * matrix(2, 2)) / determinant;
+  inversed(0, 2) = (matrix(0, 1) * matrix(1, 2) - matrix(0, 2) * matrix(1, 1)) / determinant;
+  inversed(1, 0) = (matrix(1, 2) * matrix(2, 0) - matrix(1, 0) * matrix(2, 2)) / determinant;
+  inversed(1, 1) = (matrix(0, 0) * matrix(2, 2) - matrix(0, 2) * matrix(2, 0)) / determinant;
+  inversed(1, 2) = (matrix(0, 2) * matrix(1, 0) - matrix(0, 0) * matrix(1, 2)) / determinant;
+  inversed(2, 0) = (matrix(1, 0) * matrix(2, 1) - matrix(1, 1) * matrix(2, 0)) / determinant;
+  inversed(2, 1) = (matrix(0, 1) * matrix(2, 0) - matrix(0, 0) * matrix(2, 1)) / determinant;
+  inversed(2, 2) = (matrix(0, 0) * matrix(1, 1) - matrix(0, 1) * matrix(1, 0)) / determinant;
+  return inversed;
+}
+
+// Adjugate from the same 2x2 minors as DeterminantKernel<4>.
+template<class Number>
+constexpr Matrix<Number, 4, 4> GetInversed(const Matrix<Number, 4, 4> &matrix) {
+  INSTRUMENT_CALL("Matrix", "GetInversed");
+  Number s0 = matrix(0, 0) * matrix(1, 1) - matrix(1, 0) * matrix(0, 1);
+  Number s1 = matrix(0, 0) * matrix(1, 2) - matrix(1, 0) * matrix(0, 2);
+  Number s2 = matrix(0, 0) * matrix(1, 3) - matrix(1, 0) * matrix(0, 3);
+  Number s3 = matrix(0, 1) * matrix(1, 2) - matrix(1, 1) * matrix(0, 2);
+  Number s4 = matrix(0, 1) * matrix(1, 3) - matrix(1, 1) * matrix(0, 3);
+  Number s5 = matrix(0, 2) * matrix(1, 3) - matrix(1, 2) * matrix(0, 3);
+  Number c5 = matrix(2, 2) * matrix(3, 3) - matrix(3, 2) * matrix(2, 3);
+  Number c4 = matrix(2, 1) * matrix(3, 3) - matrix(3, 1) * matrix(2, 3);
+  Number c3 = matrix(2, 1) * matrix(3, 2) - matrix(3, 1) * matrix(2, 2);
+  Number c2 = matrix(2, 0) * matrix(3, 3) - matrix(3, 0) * matrix(2, 3);
+  Number c1 = matrix(2, 0) * matrix(3, 2) - matrix(3, 0) * matrix(2, 2);
+  Number c0 = matrix(2, 0) * matrix(3, 1) - matrix(3, 0) * matrix(2, 1);
+  Number determinant = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+  if (determinant == 0) {
+    throw MatrixIsDegenerateError();
+  }
+  Matrix<Number, 4, 4> inversed;
+  inversed(0, 0) = (matrix(1, 1) * c5 - matrix(1, 2) * c4 + matrix(1, 3) * c3) / determinant;
+  inversed(0, 1) = (matrix(0, 2) * c4 - matrix(0, 1) * c5 - matrix(0, 3) * c3) / determinant;
+  inversed(0, 2) = (matrix(3, 1) * s5 - matrix(3, 2) * s4 + matrix(3, 3) * s3) / determinant;
+  inversed(0, 3) = (matrix(2, 2) * s4 - matrix(2, 1) * s5 - matrix(2, 3) * s3) / determinant;
+  inversed(1, 0) = (matrix(1, 2) * c2 - matrix(1, 0) * c5 - matrix(1, 3) * c1) / determinant;
+  inversed(1, 1) = (matrix(0, 0) * c5 - matrix(0, 2) * c2 + matrix(0, 3) * c1) / determinant;
+  inversed(1, 2) = (matrix(3, 2) * s2 - matrix(3, 0) * s5 - matrix(3, 3) * s1) / determinant;
+  inversed(1, 3) = (matrix(2, 0) * s5 - matrix(2, 2) * s2 + matrix(2, 3) * s1) / determinant;
+  inversed(2, 0) = (matrix(1, 0) * c4 - matrix(1, 1) * c2 + matrix(1, 3) * c0) / determinant;
+  inversed(2, 1) = (matrix(0, 1) * c2 - matrix(0, 0) * c4 - matrix(0, 3) * c0) / determinant;
+  inversed(2, 2) = (matrix(3, 0) * s4 - matrix(3, 1) * s2 + matrix(3, 3) * s0) / determinant;
+  inversed(2, 3) = (matrix(2, 1) * s2 - matrix(2, 0) * s4 - matrix(2, 3) * s0) / determinant;
+  inversed(3, 0) = (matrix(1, 1) * c1 - matrix(1, 0) * c3 - matrix(1, 2) * c0) / determinant;
+  inversed(3, 1) = (matrix(0, 0) * c3 - matrix(0, 1) * c1 + matrix(0, 2) * c0) / determinant;
+  inversed(3, 2) = (matrix(3, 1) * s1 - matrix(3, 0) * s3 - matrix(3, 2) * s0) / determinant;
+  inversed(3, 3) = (matrix(2, 0) * s3 - matrix(2, 1) * s1 + matrix(2, 2) * s0) / determinant;
+  return inversed;
+}
+
+template<class Number, size_t N>
+constexpr Matrix<Number, N, N> GetInversed(const Matrix<Number, N, N> &matrix) {
+  INSTRUMENT_CALL("Matrix", "GetInversed");
+  Number determinant = Determinant(matrix);
+  if (determinant == 0) {
+    throw MatrixIsDegenerateError();
+  }
+
+  Matrix<Number, N, N> inversed;
+  for (size_t i = 0; i < N; ++i) {
+    for (size_t j = 0; j < N; ++j) {
+      Number minor = Determinant(GetMinor(matrix, i, j));
+      inversed(i, j) = ((i + j) % 2 == 0 ? minor : Number() - minor) / (determinant);
+    }
+  }
+  Transpose(inversed);
+  return inversed;
+}
+
+template<class Expression, class = EnableIfLazyMatrixExpression<Expression>>
+constexpr typename Expression::NumberType Trace(const Expression &expression) {
+  return Trace(Evaluate(expression));
+}
+
+template<class Expression, class = EnableIfLazyMatrixExpression<Expression>>
+constexpr typename Expression::NumberType Determinant(const Expression &expression) {
+  return Determinant(Evaluate(expression));
+}
+
+template<class Expression, class = EnableIfLazyMatrixExpression<Expression>>
+constexpr auto GetInversed(const Expression &expression) {
+  return GetInversed(Evaluate(expression));
+}
+
+template<class Number, size_t N>
+constexpr Matrix<Number, N, N> &Inverse(Matrix<Number, N, N> &matrix) {
+  matrix = GetInversed(matrix);
+  return matrix;
+}
+
+template<class Number, size_t N>
+constexpr Matrix<Number, N, N> GetIdentity() {
+  Matrix<Number, N, N> identity;
+  for (size_t i = 0; i < N; ++i) {
+    for (size_t j = 0; j < N; ++j) {
+      identity(i, j) = i == j ? Number(1) : Number();
+    }
+  }
+  return identity;
+}
+
+// Binary exponentiation: O(N^3 log(power)) instead of O(N^3 power).
+template<class Number, size_t N>
+constexpr Matrix<Number, N, N> MatrixPow(const Matrix<Number, N, N> &matrix, uint64_t power) {
+  Matrix<Number, N, N> result = GetIdentity<Number, N>();
+  Matrix<Number, N, N> base = matrix;
+  while (power > 0) {
+    if (power % 2 == 1) {
+      result *= base;
+    }
+    power /= 2;
+    if (power > 0) {
+      base *= base;
+    }
+  }
+  return result;
+}
+
+// Both operands must be in [0, modulus). The sum is never formed directly, so moduli above half the range of
+// Number (e.g. 2^63 < modulus for uint64_t) don't overflow.
+template<class Number>
+constexpr Number AddModulo(const Number &left, const Number &right, const Number &modulus) {
+  return left >= modulus - right ? left - (modulus - right) : left + right;
+}
+
+#ifndef __SIZEOF_INT128__
+// Without a 128-bit type 64-bit products are built by doubling, one AddModulo per bit of right.
+constexpr uint64_t MultiplyModuloByDoubling(uint64_t left, uint64_t right, uint64_t modulus) {
+  left %= modulus;
+  uint64_t result = 0;
+  for (; right != 0; right /= 2) {
+    if (right % 2 == 1) {
+      result = AddModulo(result, left, modulus);
+    }
+    left = AddModulo(left, left, modulus);
+  }
+  return result;
+}
+#endif
+
+// Builtin integers up to 64 bits are multiplied in a wider type, so left * right never overflows Number.
+// Signed operands may be negative; the result is in [0, modulus).
+template<class Number>
+constexpr Number MultiplyModulo(const Number &left, const Number &right, const Number &modulus) {
+  if constexpr (std::is_integral<Number>::value && sizeof(Number) <= sizeof(uint64_t)) {
+#ifdef __SIZEOF_INT128__
+    __extension__ typedef __int128 SignedWide;
+    __extension__ typedef unsigned __int128 UnsignedWide;
+#else
+    typedef int64_t SignedWide;
+    typedef uint64_t UnsignedWide;
+    if constexpr (sizeof(Number) > sizeof(uint32_t)) {
+      Number left_residue = left % modulus < 0 ? left % modulus + modulus : left % modulus;
+      Number right_residue = right % modulus < 0 ? right % modulus + modulus : right % modulus;
+      return static_cast<Number>(MultiplyModuloByDoubling(left_residue, right_residue, modulus));
+    } else
+#endif
+    if constexpr (std::is_signed<Number>::value) {
+      SignedWide product = static_cast<SignedWide>(left) * right % modulus;
+      return static_cast<Number>(product < 0 ? product + modulus : product);
+    } else {
+      return static_cast<Number>(static_cast<UnsignedWide>(left) * right % modulus);
+    }
+  } else {
+    return left * right % modulus;
+  }
+}
+
+template<class Number, size_t N, size_t M, size_t K>
+constexpr Matrix<Number, N, K> MultiplyModulo(const Matrix<Number, N, M> &left, const Matrix<Number, M, K> &right,
+                                    const Number &modulus) {
+  if (modulus == Number()) {
+    throw MatrixZeroModulus();
+  }
+  Matrix<Number, N, K> result;
+  for (size_t i = 0; i < N; ++i) {
+    for (size_t j = 0; j < K; ++j) {
+      result(i, j) = Number();
+      for (size_t k = 0; k < M; ++k) {
+        result(i, j) = AddModulo(result(i, j), MultiplyModulo(left(i, k), right(k, j), modulus), modulus);
+      }
+    }
+  }
+  return result;
+}
+
+// Entries are kept in [0, modulus) after every product, so they never grow beyond modulus^2.
+template<class Number, size_t N>
+constexpr Matrix<Number, N, N> MatrixPow(const Matrix<Number, N, N> &matrix, uint64_t power, const Number &modulus) {
+  if (modulus == Number()) {
+    throw MatrixZeroModulus();
+  }
+  Matrix<Number, N, N> base;
+  for (size_t i = 0; i < N; ++i) {
+    for (size_t j = 0; j < N; ++j) {
+      base(i, j) = matrix(i, j) % modulus;
+      if (base(i, j) < Number()) {
+        base(i, j) += modulus;
+      }
+    }
+  }
+  Matrix<Number, N, N> result = GetIdentity<Number, N>();
+  for (size_t i = 0; i < N; ++i) {
+    result(i, i) = result(i, i) % modulus;
+  }
+  while (power > 0) {
+    if (power % 2 == 1) {
+      result = MultiplyModulo(result, base, modulus);
+    }
+    power /= 2;
+    if (power > 0) {
+      base = MultiplyModulo(base, base, modulus);
+    }
+  }
+  return result;
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,232 @@
+#ifndef MATRIX_SERIALIZATION_H_
+#define MATRIX_SERIALIZATION_H_
+
+#include <fcntl.h>
+#include <stddef.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include "matrix.h"
+
+class MatrixFormatError : public std::runtime_error {
+ public:
+  MatrixFormatError() : std::runtime_error("MatrixFormatError") {
+  }
+};
+
+class MatrixFileError : public std::runtime_error {
+ public:
+  explicit MatrixFileError(const std::string &path) : std::runtime_error("MatrixFileError: " + path) {
+  }
+};
+
+// Binary layout: MatrixBinaryHeader followed by rows * columns elements in row-major order,
+// written in the byte order of the machine. The header is 64 bytes, so the data stays aligned.
+struct MatrixBinaryHeader {
+  static const uint32_t kMagic = 0x5854414d;  // "MATX"
+  static const uint32_t kVersion = 1;
+  static const uint32_t kByteOrderMark = 0x01020304;
+
+  uint32_t magic;
+  uint32_t version;
+  uint32_t byte_order;
+  uint32_t element_type;
+  uint64_t element_size;
+  uint64_t rows;
+  uint64_t columns;
+  uint8_t reserved[24];
+};
+
+static_assert(sizeof(MatrixBinaryHeader) == 64, "MatrixBinaryHeader must be 64 bytes");
+
+enum class MatrixElementType : uint32_t {
+  kOther = 0,
+  kSigned = 1,
+  kUnsigned = 2,
+  kFloating = 3,
+};
+
+template<class Number>
+MatrixElementType GetMatrixElementType() {
+  if (std::is_floating_point<Number>::value) {
+    return MatrixElementType::kFloating;
+  }
+  if (std::is_integral<Number>::value) {
+    return std::is_signed<Number>::value ? MatrixElementType::kSigned : MatrixElementType::kUnsigned;
+  }
+  return MatrixElementType::kOther;
+}
+
+template<class Number>
+MatrixBinaryHeader MakeMatrixBinaryHeader(size_t rows, size_t columns) {
+  MatrixBinaryHeader header;
+  std::memset(&header, 0, sizeof(header));
+  header.magic = MatrixBinaryHeader::kMagic;
+  header.version = MatrixBinaryHeader::kVersion;
+  header.byte_order = MatrixBinaryHeader::kByteOrderMark;
+  header.element_type = static_cast<uint32_t>(GetMatrixElementType<Number>());
+  header.element_size = sizeof(Number);
+  header.rows = rows;
+  header.columns = columns;
+  return header;
+}
+
+template<class Number>
+void CheckMatrixBinaryHeader(const MatrixBinaryHeader &header) {
+  if (header.magic != MatrixBinaryHeader::kMagic || header.version != MatrixBinaryHeader::kVersion ||
+      header.byte_order != MatrixBinaryHeader::kByteOrderMark ||
+      header.element_type != static_cast<uint32_t>(GetMatrixElementType<Number>()) ||
+      header.element_size != sizeof(Number)) {
+    throw MatrixFormatError();
+  }
+}
+
+// Writes the header once and then any number of rows, so matrices larger than memory can be streamed.
+template<class Number>
+class MatrixBinaryWriter {
+  static_assert(std::is_trivially_copyable<Number>::value, "Binary format requires trivially copyable numbers");
+
+ public:
+  MatrixBinaryWriter(std::ostream &os, size_t rows, size_t columns) : os_(os), columns_(columns), rows_left_(rows) {
+    MatrixBinaryHeader header = MakeMatrixBinaryHeader<Number>(rows, columns);
+    os_.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  }
+
+  void WriteRows(const Number *data, size_t rows) {
+    if (rows > rows_left_) {
+      throw MatrixFormatError();
+    }
+    os_.write(reinterpret_cast<const char *>(data), static_cast<std::streamsize>(rows * columns_ * sizeof(Number)));
+    rows_left_ -= rows;
+  }
+
+  size_t RowsLeft() const {
+    return rows_left_;
+  }
+
+ private:
+  std::ostream &os_;
+  size_t columns_;
+  size_t rows_left_;
+};
+
+template<class Number, size_t N, size_t M>
+std::ostream &WriteBinary(std::ostream &os, const Matrix<Number, N, M> &matrix) {
+  MatrixBinaryWriter<Number> writer(os, N, M);
+  writer.WriteRows(&matrix(0, 0), N);
+  return os;
+}
+
+template<class Number, size_t N, size_t M>
+std::istream &ReadBinary(std::istream &is, Matrix<Number, N, M> &matrix) {
+  static_assert(std::is_trivially_copyable<Number>::value, "Binary format requires trivially copyable numbers");
+  MatrixBinaryHeader header;
+  if (!is.read(reinterpret_cast<char *>(&header), sizeof(header))) {
+    throw MatrixFormatError();
+  }
+  CheckMatrixBinaryHeader<Number>(header);
+  if (header.rows != N || header.columns != M) {
+    throw MatrixFormatError();
+  }
+  if (!is.read(reinterpret_cast<char *>(&matrix(0, 0)), static_cast<std::streamsize>(N * M * sizeof(Number)))) {
+    throw MatrixFormatError();
+  }
+  return is;
+}
+
+// Read-only view of a matrix file mapped into memory. Elements are not copied or parsed:
+// pages are loaded by the OS on first access.
+template<class Number>
+class MappedMatrix {
+  static_assert(std::is_trivially_copyable<Number>::value, "Binary format requires trivially copyable numbers");
+
+ public:
+  explicit MappedMatrix(const std::string &path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      throw MatrixFileError(path);
+    }
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0 || static_cast<size_t>(file_stat.st_size) < sizeof(MatrixBinaryHeader)) {
+      close(fd);
+      throw MatrixFormatError();
+    }
+    size_ = static_cast<size_t>(file_stat.st_size);
+    void *address = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (address == MAP_FAILED) {
+      throw MatrixFileError(path);
+    }
+    address_ = address;
+
+    const MatrixBinaryHeader &header = *static_cast<const MatrixBinaryHeader *>(address_);
+    try {
+      CheckMatrixBinaryHeader<Number>(header);
+      if (header.columns != 0 && header.rows > (size_ - sizeof(header)) / sizeof(Number) / header.columns) {
+        throw MatrixFormatError();
+      }
+    } catch (...) {
+      munmap(address_, size_);
+      throw;
+    }
+    rows_ = header.rows;
+    columns_ = header.columns;
+    data_ = reinterpret_cast<const Number *>(static_cast<const char *>(address_) + sizeof(header));
+  }
+
+  MappedMatrix(const MappedMatrix &) = delete;
+  MappedMatrix &operator=(const MappedMatrix &) = delete;
+
+  ~MappedMatrix() {
+    munmap(address_, size_);
+  }
+
+  size_t RowsNumber() const {
+    return rows_;
+  }
+
+  size_t ColumnsNumber() const {
+    return columns_;
+  }
+
+  const Number *Data() const {
+    return data_;
+  }
+
+  const Number &operator()(size_t i, size_t j) const {
+    return data_[i * columns_ + j];
+  }
+
+  const Number &At(size_t i, size_t j) const {
+    if (i < rows_ && j < columns_) {
+      return data_[i * columns_ + j];
+    }
+    throw MatrixOutOfRange();
+  }
+
+  template<size_t N, size_t M>
+  Matrix<Number, N, M> ToMatrix() const {
+    if (rows_ != N || columns_ != M) {
+      throw MatrixFormatError();
+    }
+    Matrix<Number, N, M> matrix;
+    std::memcpy(&matrix(0, 0), data_, N * M * sizeof(Number));
+    return matrix;
+  }
+
+ private:
+  void *address_ = nullptr;
+  size_t size_ = 0;
+  size_t rows_ = 0;
+  size_t columns_ = 0;
+  const Number *data_ = nullptr;
+};
+
+#endif
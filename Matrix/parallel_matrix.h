@@ -0,0 +1,154 @@
+#ifndef PARALLEL_MATRIX_H_
+#define PARALLEL_MATRIX_H_
+
+#include <stddef.h>
+#include <algorithm>
+
+#include "matrix.h"
+#include "thread_pool.h"
+
+class MatrixSequencedPolicy {
+};
+
+class MatrixParallelPolicy {
+ public:
+  // Operations touching fewer scalars than the threshold run on the calling thread.
+  static const size_t kDefaultThreshold = 1 << 16;
+
+  explicit MatrixParallelPolicy(ThreadPool &pool, size_t threshold = kDefaultThreshold)
+      : pool_(&pool), threshold_(threshold) {
+  }
+
+  ThreadPool &Pool() const {
+    return *pool_;
+  }
+
+  size_t Threshold() const {
+    return threshold_;
+  }
+
+  // Splits a rows x columns block into row or column stripes, whichever gives every thread work,
+  // and calls body(row_begin, row_end, column_begin, column_end) for each of them.
+  template<class Function>
+  void ForEachBlock(size_t rows, size_t columns, size_t work, Function body) const {
+    if (work < threshold_ || pool_->ThreadsNumber() <= 1) {
+      body(size_t(0), rows, size_t(0), columns);
+      return;
+    }
+    size_t chunks_number = pool_->ThreadsNumber() * 4;
+    if (rows >= pool_->ThreadsNumber() || rows >= columns) {
+      pool_->ParallelFor(rows, chunks_number, [&body, columns](size_t begin, size_t end) {
+        body(begin, end, size_t(0), columns);
+      });
+    } else {
+      pool_->ParallelFor(columns, chunks_number, [&body, rows](size_t begin, size_t end) {
+        body(size_t(0), rows, begin, end);
+      });
+    }
+  }
+
+ private:
+  ThreadPool *pool_;
+  size_t threshold_;
+};
+
+template<class Number, size_t N, size_t M>
+Matrix<Number, N, M> Add(MatrixSequencedPolicy, const Matrix<Number, N, M> &left, const Matrix<Number, N, M> &right) {
+  return left + right;
+}
+
+template<class Number, size_t N, size_t M>
+Matrix<Number, N, M> Add(const MatrixParallelPolicy &policy, const Matrix<Number, N, M> &left,
+                         const Matrix<Number, N, M> &right) {
+  Matrix<Number, N, M> result;
+  policy.ForEachBlock(N, M, N * M, [&](size_t row_begin, size_t row_end, size_t col_begin, size_t col_end) {
+    for (size_t i = row_begin; i < row_end; ++i) {
+      for (size_t j = col_begin; j < col_end; ++j) {
+        result(i, j) = left(i, j) + right(i, j);
+      }
+    }
+  });
+  return result;
+}
+
+template<class Number, size_t N, size_t M>
+Matrix<Number, N, M> Subtract(MatrixSequencedPolicy, const Matrix<Number, N, M> &left,
+                              const Matrix<Number, N, M> &right) {
+  return left - right;
+}
+
+template<class Number, size_t N, size_t M>
+Matrix<Number, N, M> Subtract(const MatrixParallelPolicy &policy, const Matrix<Number, N, M> &left,
+                              const Matrix<Number, N, M> &right) {
+  Matrix<Number, N, M> result;
+  policy.ForEachBlock(N, M, N * M, [&](size_t row_begin, size_t row_end, size_t col_begin, size_t col_end) {
+    for (size_t i = row_begin; i < row_end; ++i) {
+      for (size_t j = col_begin; j < col_end; ++j) {
+        result(i, j) = left(i, j) - right(i, j);
+      }
+    }
+  });
+  return result;
+}
+
+template<class Number, size_t N, size_t M, size_t K>
+Matrix<Number, N, K> Multiply(MatrixSequencedPolicy, const Matrix<Number, N, M> &left,
+                              const Matrix<Number, M, K> &right) {
+  return left * right;
+}
+
+template<class Number, size_t N, size_t M, size_t K>
+Matrix<Number, N, K> Multiply(const MatrixParallelPolicy &policy, const Matrix<Number, N, M> &left,
+                              const Matrix<Number, M, K> &right) {
+  Matrix<Number, N, K> result;
+  policy.ForEachBlock(N, K, N * M * K, [&](size_t row_begin, size_t row_end, size_t col_begin, size_t col_end) {
+    for (size_t i = row_begin; i < row_end; ++i) {
+      for (size_t j = col_begin; j < col_end; ++j) {
+        result(i, j) = Number();
+      }
+      for (size_t k = 0; k < M; ++k) {
+        for (size_t j = col_begin; j < col_end; ++j) {
+          result(i, j) += left(i, k) * right(k, j);
+        }
+      }
+    }
+  });
+  return result;
+}
+
+template<class Number, size_t N, size_t M>
+Matrix<Number, N, M> &MultiplyBy(MatrixSequencedPolicy, Matrix<Number, N, M> &matrix, const int n) {
+  return matrix *= n;
+}
+
+template<class Number, size_t N, size_t M>
+Matrix<Number, N, M> &MultiplyBy(const MatrixParallelPolicy &policy, Matrix<Number, N, M> &matrix, const int n) {
+  policy.ForEachBlock(N, M, N * M, [&](size_t row_begin, size_t row_end, size_t col_begin, size_t col_end) {
+    for (size_t i = row_begin; i < row_end; ++i) {
+      for (size_t j = col_begin; j < col_end; ++j) {
+        matrix(i, j) *= n;
+      }
+    }
+  });
+  return matrix;
+}
+
+template<class Number, size_t N, size_t M>
+Matrix<Number, N, M> Divide(MatrixSequencedPolicy, const Matrix<Number, N, M> &matrix, const int n) {
+  return matrix / n;
+}
+
+template<class Number, size_t N, size_t M>
+Matrix<Number, N, M> Divide(const MatrixParallelPolicy &policy, const Matrix<Number, N, M> &matrix, const int n) {
+  Matrix<Number, N, M> result;
+  policy.ForEachBlock(N, M, N * M, [&](size_t row_begin, size_t row_end, size_t col_begin, size_t col_end) {
+    for (size_t i = row_begin; i < row_end; ++i) {
+      for (size_t j = col_begin; j < col_end; ++j) {
+        result(i, j) = matrix(i, j) / n;
+      }
+    }
+  });
+  return result;
+}
+
+#endif
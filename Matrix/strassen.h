@@ -0,0 +1,169 @@
+#ifndef STRASSEN_H_
+#define STRASSEN_H_
+
+#include <stddef.h>
+#include <algorithm>
+#include <vector>
+
+#include "matrix.h"
+
+// Below this size the recursion falls back to the blocked classical kernel.
+// Types with expensive multiplication, such as BigInteger, profit from a smaller cutoff.
+const size_t kStrassenCutoff = 64;
+const size_t kStrassenBlockSize = 32;
+
+template<class Number>
+void StrassenAdd(const Number *a, size_t lda, const Number *b, size_t ldb, Number *c, size_t ldc, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    for (size_t j = 0; j < n; ++j) {
+      c[i * ldc + j] = a[i * lda + j] + b[i * ldb + j];
+    }
+  }
+}
+
+template<class Number>
+void StrassenSubtract(const Number *a, size_t lda, const Number *b, size_t ldb, Number *c, size_t ldc, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    for (size_t j = 0; j < n; ++j) {
+      c[i * ldc + j] = a[i * lda + j] - b[i * ldb + j];
+    }
+  }
+}
+
+template<class Number>
+void BlockedMultiply(const Number *a, size_t lda, const Number *b, size_t ldb, Number *c, size_t ldc, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    for (size_t j = 0; j < n; ++j) {
+      c[i * ldc + j] = Number();
+    }
+  }
+  for (size_t ii = 0; ii < n; ii += kStrassenBlockSize) {
+    size_t i_end = std::min(ii + kStrassenBlockSize, n);
+    for (size_t kk = 0; kk < n; kk += kStrassenBlockSize) {
+      size_t k_end = std::min(kk + kStrassenBlockSize, n);
+      for (size_t jj = 0; jj < n; jj += kStrassenBlockSize) {
+        size_t j_end = std::min(jj + kStrassenBlockSize, n);
+        for (size_t i = ii; i < i_end; ++i) {
+          for (size_t k = kk; k < k_end; ++k) {
+            const Number &a_ik = a[i * lda + k];
+            for (size_t j = jj; j < j_end; ++j) {
+              c[i * ldc + j] += a_ik * b[k * ldb + j];
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+// Winograd's form of Strassen's algorithm: 7 half-size products and 15 additions per level.
+// n must be divisible by 2 at every level above the cutoff.
+template<class Number>
+void StrassenWinogradMultiply(const Number *a, size_t lda, const Number *b, size_t ldb, Number *c, size_t ldc,
+                              size_t n, size_t cutoff) {
+  if (n <= cutoff || n % 2 != 0) {
+    BlockedMultiply(a, lda, b, ldb, c, ldc, n);
+    return;
+  }
+
+  size_t h = n / 2;
+  const Number *a11 = a;
+  const Number *a12 = a + h;
+  const Number *a21 = a + h * lda;
+  const Number *a22 = a + h * lda + h;
+  const Number *b11 = b;
+  const Number *b12 = b + h;
+  const Number *b21 = b + h * ldb;
+  const Number *b22 = b + h * ldb + h;
+  Number *c11 = c;
+  Number *c12 = c + h;
+  Number *c21 = c + h * ldc;
+  Number *c22 = c + h * ldc + h;
+
+  std::vector<Number> s(h * h);
+  std::vector<Number> t(h * h);
+  std::vector<Number> m1(h * h);
+  std::vector<Number> m2(h * h);
+
+  // C11 = M1 + M2, where M1 = A11 * B11 and M2 = A12 * B21.
+  StrassenWinogradMultiply(a11, lda, b11, ldb, m1.data(), h, h, cutoff);
+  StrassenWinogradMultiply(a12, lda, b21, ldb, m2.data(), h, h, cutoff);
+  StrassenAdd(m1.data(), h, m2.data(), h, c11, ldc, h);
+
+  // U2 = M1 + M6 is kept in m1, M6 = S2 * T2, S2 = A21 + A22 - A11, T2 = B22 - B12 + B11.
+  StrassenAdd(a21, lda, a22, lda, s.data(), h, h);
+  StrassenSubtract(s.data(), h, a11, lda, s.data(), h, h);
+  StrassenSubtract(b22, ldb, b12, ldb, t.data(), h, h);
+  StrassenAdd(t.data(), h, b11, ldb, t.data(), h, h);
+  StrassenWinogradMultiply(s.data(), h, t.data(), h, m2.data(), h, h, cutoff);
+  StrassenAdd(m1.data(), h, m2.data(), h, m1.data(), h, h);
+
+  // C12 = U2 + M5 + M3, C22 = U2 + M7 + M5 and C21 = U2 + M7 - M4 are accumulated from U2.
+  // M3 = S4 * B22, S4 = A12 - S2.
+  StrassenSubtract(a12, lda, s.data(), h, s.data(), h, h);
+  StrassenWinogradMultiply(s.data(), h, b22, ldb, m2.data(), h, h, cutoff);
+  StrassenAdd(m1.data(), h, m2.data(), h, c12, ldc, h);
+
+  // M4 = A22 * T4, T4 = T2 - B21.
+  StrassenSubtract(t.data(), h, b21, ldb, t.data(), h, h);
+  StrassenWinogradMultiply(a22, lda, t.data(), h, m2.data(), h, h, cutoff);
+  StrassenSubtract(m1.data(), h, m2.data(), h, c21, ldc, h);
+
+  // M7 = S3 * T3, S3 = A11 - A21, T3 = B22 - B12.
+  StrassenSubtract(a11, lda, a21, lda, s.data(), h, h);
+  StrassenSubtract(b22, ldb, b12, ldb, t.data(), h, h);
+  StrassenWinogradMultiply(s.data(), h, t.data(), h, m2.data(), h, h, cutoff);
+  StrassenAdd(m1.data(), h, m2.data(), h, m1.data(), h, h);
+  StrassenAdd(c21, ldc, m2.data(), h, c21, ldc, h);
+
+  // M5 = S1 * T1, S1 = A21 + A22, T1 = B12 - B11.
+  StrassenAdd(a21, lda, a22, lda, s.data(), h, h);
+  StrassenSubtract(b12, ldb, b11, ldb, t.data(), h, h);
+  StrassenWinogradMultiply(s.data(), h, t.data(), h, m2.data(), h, h, cutoff);
+  StrassenAdd(c12, ldc, m2.data(), h, c12, ldc, h);
+  StrassenAdd(m1.data(), h, m2.data(), h, c22, ldc, h);
+}
+
+// Sizes that do not halve evenly down to the cutoff are padded with zeros once, up to the nearest size that does.
+template<class Number, size_t N>
+Matrix<Number, N, N> StrassenMultiply(const Matrix<Number, N, N> &left, const Matrix<Number, N, N> &right,
+                                      size_t cutoff = kStrassenCutoff) {
+  INSTRUMENT_CALL("Matrix", "StrassenMultiply");
+  cutoff = std::max<size_t>(cutoff, 1);
+  Matrix<Number, N, N> result;
+  if (N <= cutoff) {
+    BlockedMultiply(&left(0, 0), N, &right(0, 0), N, &result(0, 0), N, N);
+    return result;
+  }
+
+  size_t levels = 0;
+  size_t base = N;
+  while (base > cutoff) {
+    base = (base + 1) / 2;
+    ++levels;
+  }
+  size_t padded = base << levels;
+  if (padded == N) {
+    StrassenWinogradMultiply(&left(0, 0), N, &right(0, 0), N, &result(0, 0), N, N, cutoff);
+    return result;
+  }
+
+  std::vector<Number> a(padded * padded);
+  std::vector<Number> b(padded * padded);
+  std::vector<Number> c(padded * padded);
+  for (size_t i = 0; i < N; ++i) {
+    for (size_t j = 0; j < N; ++j) {
+      a[i * padded + j] = left(i, j);
+      b[i * padded + j] = right(i, j);
+    }
+  }
+  StrassenWinogradMultiply(a.data(), padded, b.data(), padded, c.data(), padded, padded, cutoff);
+  for (size_t i = 0; i < N; ++i) {
+    for (size_t j = 0; j < N; ++j) {
+      result(i, j) = c[i * padded + j];
+    }
+  }
+  return result;
+}
+
+#endif
@@ -0,0 +1,194 @@
+#ifndef THREAD_POOL_H_
+#define THREAD_POOL_H_
+
+#include <stddef.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+ public:
+  explicit ThreadPool(size_t threads_number = std::thread::hardware_concurrency()) {
+    threads_number = std::max<size_t>(threads_number, 1);
+    for (size_t i = 0; i < threads_number; ++i) {
+      queues_.push_back(std::make_unique<WorkerQueue>());
+    }
+    for (size_t i = 0; i < threads_number; ++i) {
+      workers_.emplace_back([this, i] {
+        WorkerLoop(i);
+      });
+    }
+  }
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(sleep_mutex_);
+      stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto &worker : workers_) {
+      worker.join();
+    }
+  }
+
+  size_t ThreadsNumber() const {
+    return workers_.size();
+  }
+
+  void Submit(std::function<void()> task) {
+    size_t index = next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+    {
+      std::lock_guard<std::mutex> lock(sleep_mutex_);
+      ++pending_;
+    }
+    try {
+      std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+      queues_[index]->tasks.push_back(std::move(task));
+    } catch (...) {
+      --pending_;
+      throw;
+    }
+    wake_.notify_one();
+  }
+
+  // Calls body(begin, end) on consecutive chunks of [0, size) and returns when all of them are done.
+  // The calling thread executes queued tasks while waiting, so nested calls do not deadlock.
+  template<class Function>
+  void ParallelFor(size_t size, size_t chunks_number, Function body) {
+    chunks_number = std::min(std::max<size_t>(chunks_number, 1), size);
+    if (chunks_number <= 1) {
+      if (size != 0) {
+        body(size_t(0), size);
+      }
+      return;
+    }
+
+    // remaining counts only chunks which were actually submitted: if Submit throws, the chunks already queued are
+    // waited for and the exception is rethrown.
+    auto state = std::make_shared<ParallelForState>();
+    std::exception_ptr submit_exception;
+    try {
+      for (size_t chunk = 0; chunk < chunks_number; ++chunk) {
+        size_t begin = size * chunk / chunks_number;
+        size_t end = size * (chunk + 1) / chunks_number;
+        state->remaining.fetch_add(1, std::memory_order_relaxed);
+        try {
+          Submit([state, body, begin, end] {
+            try {
+              body(begin, end);
+            } catch (...) {
+              std::lock_guard<std::mutex> lock(state->mutex);
+              if (!state->exception) {
+                state->exception = std::current_exception();
+              }
+            }
+            if (state->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+              std::lock_guard<std::mutex> lock(state->mutex);
+              state->done.notify_all();
+            }
+          });
+        } catch (...) {
+          state->remaining.fetch_sub(1, std::memory_order_relaxed);
+          throw;
+        }
+      }
+    } catch (...) {
+      submit_exception = std::current_exception();
+    }
+
+    // Chunks are never requeued, so once no queue has a task left all of them are running on workers and the caller
+    // can sleep until the last one finishes.
+    std::function<void()> task;
+    while (state->remaining.load(std::memory_order_acquire) != 0) {
+      if (TrySteal(0, task)) {
+        task();
+        continue;
+      }
+      std::unique_lock<std::mutex> lock(state->mutex);
+      state->done.wait(lock, [&state] {
+        return state->remaining.load(std::memory_order_acquire) == 0;
+      });
+    }
+    if (submit_exception) {
+      std::rethrow_exception(submit_exception);
+    }
+    if (state->exception) {
+      std::rethrow_exception(state->exception);
+    }
+  }
+
+ private:
+  struct WorkerQueue {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  struct ParallelForState {
+    std::atomic<size_t> remaining{0};
+    std::mutex mutex;
+    std::condition_variable done;
+    std::exception_ptr exception;
+  };
+
+  std::vector<std::unique_ptr<WorkerQueue>> queues_;
+  std::vector<std::thread> workers_;
+  std::mutex sleep_mutex_;
+  std::condition_variable wake_;
+  std::atomic<size_t> pending_{0};
+  std::atomic<size_t> next_queue_{0};
+  bool stop_ = false;
+
+  bool TryPop(size_t index, std::function<void()> &task) {
+    std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+    if (queues_[index]->tasks.empty()) {
+      return false;
+    }
+    task = std::move(queues_[index]->tasks.front());
+    queues_[index]->tasks.pop_front();
+    --pending_;
+    return true;
+  }
+
+  bool TrySteal(size_t index, std::function<void()> &task) {
+    for (size_t shift = 0; shift < queues_.size(); ++shift) {
+      WorkerQueue &victim = *queues_[(index + shift) % queues_.size()];
+      std::lock_guard<std::mutex> lock(victim.mutex);
+      if (!victim.tasks.empty()) {
+        task = std::move(victim.tasks.back());
+        victim.tasks.pop_back();
+        --pending_;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void WorkerLoop(size_t index) {
+    std::function<void()> task;
+    while (true) {
+      if (TryPop(index, task) || TrySteal(index + 1, task)) {
+        task();
+        continue;
+      }
+      std::unique_lock<std::mutex> lock(sleep_mutex_);
+      wake_.wait(lock, [this] {
+        return stop_ || pending_ != 0;
+      });
+      if (stop_ && pending_ == 0) {
+        return;
+      }
+    }
+  }
+};
+
+#endif
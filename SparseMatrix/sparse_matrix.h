@@ -0,0 +1,226 @@
+#ifndef SPARSE_MATRIX_H_
+#define SPARSE_MATRIX_H_
+
+#include <stddef.h>
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "../Matrix/matrix.h"
+
+class SparseMatrixOutOfRange : public std::out_of_range {
+ public:
+  SparseMatrixOutOfRange() : std::out_of_range("SparseMatrixOutOfRange") {
+  }
+};
+
+class SparseMatrixSizeMismatch : public std::invalid_argument {
+ public:
+  SparseMatrixSizeMismatch() : std::invalid_argument("SparseMatrixSizeMismatch") {
+  }
+};
+
+template<class Number>
+struct Triplet {
+  size_t row;
+  size_t column;
+  Number value;
+};
+
+// Compressed sparse row storage: non-zeros of row i are values_[row_offsets_[i] .. row_offsets_[i + 1])
+// with their columns in column_indices_, sorted by column. The CSR arrays of GetTransposed(matrix)
+// are the compressed sparse column arrays of matrix.
+template<class Number>
+class SparseMatrix {
+ public:
+  SparseMatrix() : SparseMatrix(0, 0) {
+  }
+
+  SparseMatrix(size_t rows, size_t columns) : rows_(rows), columns_(columns), row_offsets_(rows + 1, 0) {
+  }
+
+  // Duplicated positions are summed up, zeros are not stored.
+  static SparseMatrix FromTriplets(size_t rows, size_t columns, std::vector<Triplet<Number>> triplets) {
+    for (const auto &triplet : triplets) {
+      if (triplet.row >= rows || triplet.column >= columns) {
+        throw SparseMatrixOutOfRange();
+      }
+    }
+    std::sort(triplets.begin(), triplets.end(), [](const Triplet<Number> &left, const Triplet<Number> &right) {
+      return left.row != right.row ? left.row < right.row : left.column < right.column;
+    });
+
+    SparseMatrix result(rows, columns);
+    result.column_indices_.reserve(triplets.size());
+    result.values_.reserve(triplets.size());
+    for (size_t i = 0; i < triplets.size();) {
+      size_t row = triplets[i].row;
+      size_t column = triplets[i].column;
+      Number value = triplets[i].value;
+      for (++i; i < triplets.size() && triplets[i].row == row && triplets[i].column == column; ++i) {
+        value += triplets[i].value;
+      }
+      if (value != Number()) {
+        result.column_indices_.push_back(column);
+        result.values_.push_back(std::move(value));
+        ++result.row_offsets_[row + 1];
+      }
+    }
+    for (size_t i = 0; i < rows; ++i) {
+      result.row_offsets_[i + 1] += result.row_offsets_[i];
+    }
+    return result;
+  }
+
+  template<size_t N, size_t M>
+  static SparseMatrix FromDense(const Matrix<Number, N, M> &matrix) {
+    SparseMatrix result(N, M);
+    for (size_t i = 0; i < N; ++i) {
+      for (size_t j = 0; j < M; ++j) {
+        if (matrix(i, j) != Number()) {
+          result.column_indices_.push_back(j);
+          result.values_.push_back(matrix(i, j));
+        }
+      }
+      result.row_offsets_[i + 1] = result.values_.size();
+    }
+    return result;
+  }
+
+  template<size_t N, size_t M>
+  Matrix<Number, N, M> ToDense() const {
+    if (rows_ != N || columns_ != M) {
+      throw SparseMatrixSizeMismatch();
+    }
+    Matrix<Number, N, M> result;
+    for (size_t i = 0; i < N; ++i) {
+      for (size_t j = 0; j < M; ++j) {
+        result(i, j) = Number();
+      }
+      for (size_t k = row_offsets_[i]; k < row_offsets_[i + 1]; ++k) {
+        result(i, column_indices_[k]) = values_[k];
+      }
+    }
+    return result;
+  }
+
+  size_t RowsNumber() const {
+    return rows_;
+  }
+
+  size_t ColumnsNumber() const {
+    return columns_;
+  }
+
+  size_t NonZerosNumber() const {
+    return values_.size();
+  }
+
+  const std::vector<size_t> &RowOffsets() const {
+    return row_offsets_;
+  }
+
+  const std::vector<size_t> &ColumnIndices() const {
+    return column_indices_;
+  }
+
+  const std::vector<Number> &Values() const {
+    return values_;
+  }
+
+  Number At(size_t i, size_t j) const {
+    if (i >= rows_ || j >= columns_) {
+      throw SparseMatrixOutOfRange();
+    }
+    auto begin = column_indices_.begin() + row_offsets_[i];
+    auto end = column_indices_.begin() + row_offsets_[i + 1];
+    auto it = std::lower_bound(begin, end, j);
+    if (it == end || *it != j) {
+      return Number();
+    }
+    return values_[it - column_indices_.begin()];
+  }
+
+  friend std::vector<Number> operator*(const SparseMatrix &matrix, const std::vector<Number> &vector) {
+    if (vector.size() != matrix.columns_) {
+      throw SparseMatrixSizeMismatch();
+    }
+    std::vector<Number> result(matrix.rows_);
+    for (size_t i = 0; i < matrix.rows_; ++i) {
+      Number sum = Number();
+      for (size_t k = matrix.row_offsets_[i]; k < matrix.row_offsets_[i + 1]; ++k) {
+        sum += matrix.values_[k] * vector[matrix.column_indices_[k]];
+      }
+      result[i] = sum;
+    }
+    return result;
+  }
+
+  // The number of result rows N can't be deduced from the operands, so it is given explicitly:
+  // sparse.Multiply<N>(dense).
+  template<size_t N, size_t M, size_t K>
+  Matrix<Number, N, K> Multiply(const Matrix<Number, M, K> &dense) const {
+    if (rows_ != N || columns_ != M) {
+      throw SparseMatrixSizeMismatch();
+    }
+    Matrix<Number, N, K> result;
+    for (size_t i = 0; i < N; ++i) {
+      for (size_t j = 0; j < K; ++j) {
+        result(i, j) = Number();
+      }
+      for (size_t k = row_offsets_[i]; k < row_offsets_[i + 1]; ++k) {
+        const Number &value = values_[k];
+        size_t row = column_indices_[k];
+        for (size_t j = 0; j < K; ++j) {
+          result(i, j) += value * dense(row, j);
+        }
+      }
+    }
+    return result;
+  }
+
+  friend SparseMatrix GetTransposed(const SparseMatrix &matrix) {
+    SparseMatrix transposed(matrix.columns_, matrix.rows_);
+    for (size_t column : matrix.column_indices_) {
+      ++transposed.row_offsets_[column + 1];
+    }
+    for (size_t i = 0; i < transposed.rows_; ++i) {
+      transposed.row_offsets_[i + 1] += transposed.row_offsets_[i];
+    }
+    transposed.column_indices_.resize(matrix.values_.size());
+    transposed.values_.resize(matrix.values_.size());
+    std::vector<size_t> positions(transposed.row_offsets_.begin(), transposed.row_offsets_.end() - 1);
+    for (size_t i = 0; i < matrix.rows_; ++i) {
+      for (size_t k = matrix.row_offsets_[i]; k < matrix.row_offsets_[i + 1]; ++k) {
+        size_t position = positions[matrix.column_indices_[k]]++;
+        transposed.column_indices_[position] = i;
+        transposed.values_[position] = matrix.values_[k];
+      }
+    }
+    return transposed;
+  }
+
+  friend SparseMatrix &Transpose(SparseMatrix &matrix) {
+    matrix = GetTransposed(matrix);
+    return matrix;
+  }
+
+  friend bool operator==(const SparseMatrix &left, const SparseMatrix &right) {
+    return left.rows_ == right.rows_ && left.columns_ == right.columns_ && left.row_offsets_ == right.row_offsets_ &&
+        left.column_indices_ == right.column_indices_ && left.values_ == right.values_;
+  }
+
+  friend bool operator!=(const SparseMatrix &left, const SparseMatrix &right) {
+    return !(left == right);
+  }
+
+ private:
+  size_t rows_;
+  size_t columns_;
+  std::vector<size_t> row_offsets_;
+  std::vector<size_t> column_indices_;
+  std::vector<Number> values_;
+};
+
+#endif
@@ -0,0 +1,106 @@
+#include <stddef.h>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "../Matrix/batched_matrix.h"
+#include "check.h"
+
+const size_t kBatchSize = 37;
+
+template<class Number, size_t N, size_t M>
+BatchedMatrix<Number, N, M> RandomBatch(std::mt19937_64 &generator) {
+  std::uniform_real_distribution<double> distribution(-1, 1);
+  BatchedMatrix<Number, N, M> batch(kBatchSize);
+  for (size_t t = 0; t < kBatchSize; ++t) {
+    for (size_t i = 0; i < N; ++i) {
+      for (size_t j = 0; j < M; ++j) {
+        batch(t, i, j) = static_cast<Number>(distribution(generator) + (i == j ? 2 : 0));
+      }
+    }
+  }
+  return batch;
+}
+
+template<size_t N, size_t M>
+bool IsClose(const Matrix<double, N, M> &left, const Matrix<double, N, M> &right) {
+  for (size_t i = 0; i < N; ++i) {
+    for (size_t j = 0; j < M; ++j) {
+      if (std::fabs(left(i, j) - right(i, j)) > 1e-9 * (1 + std::fabs(right(i, j)))) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Every matrix of the batch is checked against the Matrix kernels.
+template<size_t N>
+void CheckDeterminantAndInverse() {
+  std::mt19937_64 generator(N);
+  BatchedMatrix<double, N, N> batch = RandomBatch<double, N, N>(generator);
+  std::vector<double> determinant = Determinant(batch);
+  BatchedMatrix<double, N, N> inversed = GetInversed(batch);
+  CHECK(determinant.size() == kBatchSize && inversed.Size() == kBatchSize);
+  for (size_t t = 0; t < kBatchSize; ++t) {
+    Matrix<double, N, N> matrix = batch.Get(t);
+    double expected = Determinant(matrix);
+    CHECK(std::fabs(determinant[t] - expected) <= 1e-9 * (1 + std::fabs(expected)));
+    CHECK(IsClose(inversed.Get(t), GetInversed(matrix)));
+  }
+
+  batch.Set(kBatchSize / 2, Matrix<double, N, N>());
+  CHECK(Determinant(batch)[kBatchSize / 2] == 0);
+  CHECK_THROWS(GetInversed(batch), MatrixIsDegenerateError);
+}
+
+void CheckIntegerDeterminant() {
+  BatchedMatrix<int64_t, 4, 4> batch(2);
+  for (size_t i = 0; i < 4; ++i) {
+    for (size_t j = 0; j < 4; ++j) {
+      batch(0, i, j) = static_cast<int64_t>((i * 7 + j * 3) % 11) - 5;
+      batch(1, i, j) = i == j ? static_cast<int64_t>(i + 1) : 0;
+    }
+  }
+  std::vector<int64_t> determinant = Determinant(batch);
+  CHECK(determinant[0] == Determinant(batch.Get(0)) && determinant[1] == 24);
+}
+
+void CheckProducts() {
+  std::mt19937_64 generator(34);
+  BatchedMatrix<double, 3, 4> left = RandomBatch<double, 3, 4>(generator);
+  BatchedMatrix<double, 4, 2> right = RandomBatch<double, 4, 2>(generator);
+  BatchedMatrix<double, 3, 2> product = left * right;
+  for (size_t t = 0; t < kBatchSize; ++t) {
+    Matrix<double, 3, 2> expected = left.Get(t) * right.Get(t);
+    CHECK(IsClose(product.Get(t), expected));
+  }
+
+  Matrix<double, 2, 3> transform;
+  for (size_t i = 0; i < 2; ++i) {
+    for (size_t j = 0; j < 3; ++j) {
+      transform(i, j) = static_cast<double>(i + 2 * j) - 1.5;
+    }
+  }
+  BatchedMatrix<double, 2, 4> transformed = transform * left;
+  for (size_t t = 0; t < kBatchSize; ++t) {
+    Matrix<double, 2, 4> expected = transform * left.Get(t);
+    CHECK(IsClose(transformed.Get(t), expected));
+  }
+
+  BatchedMatrix<double, 4, 2> shorter(kBatchSize - 1);
+  CHECK_THROWS(left * shorter, BatchedMatrixSizeMismatch);
+  CHECK_THROWS(left.Get(kBatchSize), MatrixOutOfRange);
+  CHECK_THROWS(left.Set(kBatchSize, Matrix<double, 3, 4>()), MatrixOutOfRange);
+}
+
+int main() {
+  CheckDeterminantAndInverse<1>();
+  CheckDeterminantAndInverse<2>();
+  CheckDeterminantAndInverse<3>();
+  CheckDeterminantAndInverse<4>();
+  CheckIntegerDeterminant();
+  CheckProducts();
+  return 0;
+}
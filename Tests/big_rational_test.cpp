@@ -0,0 +1,121 @@
+#include <stddef.h>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../BigRational/big_rational.h"
+#include "check.h"
+
+BigInteger Big(const std::string &digits) {
+  return BigInteger(digits.data(), digits.data() + digits.size());
+}
+
+std::string ToString(const BigRational &value) {
+  std::ostringstream os;
+  os << value;
+  return os.str();
+}
+
+BigRational Parse(const std::string &input) {
+  std::istringstream is(input);
+  BigRational value;
+  is >> value;
+  return value;
+}
+
+void CheckSigns() {
+  CHECK(ToString(BigRational(3, -6)) == "-1/2");
+  CHECK(ToString(BigRational(-3, -6)) == "1/2");
+  CHECK(BigRational(3, -6).Denominator() == BigInteger(2));
+  CHECK(BigRational(3, -6).Numerator() == BigInteger(-1));
+  CHECK(BigRational(3, -6).IsNegative() && !BigRational(-3, -6).IsNegative());
+  CHECK(BigRational(0, -5) == BigRational());
+  CHECK(ToString(BigRational(0, -5)) == "0");
+  CHECK(ToString(BigRational(1, 2) / BigRational(-1, 3)) == "-3/2");
+  CHECK_THROWS(BigRational(1, 0), BigRationalDivisionByZero);
+  CHECK_THROWS(BigRational(1) / BigRational(0, 7), BigRationalDivisionByZero);
+}
+
+void CheckComparisons() {
+  CHECK(BigInteger(-3) < BigInteger(-2) && !(BigInteger(-2) < BigInteger(-3)));
+  CHECK(Big("-1000000000000") < BigInteger(-999) && BigInteger(-999) > Big("-1000000000000"));
+  BigRational half(1, 2);
+  BigRational two_quarters(2, 4);
+  BigRational third(1, 3);
+  CHECK(half == two_quarters && !(half != two_quarters));
+  CHECK(third < half && half > third && third <= half && half >= two_quarters);
+  CHECK(!(half < two_quarters) && !(two_quarters < half));
+  CHECK(BigRational(-1, 2) < BigRational(-1, 3) && BigRational(-1, 2) < third);
+  CHECK(BigRational(-2, 4) != half && BigRational(-2, 4) == BigRational(1, -2));
+  CHECK(BigRational(0, 3) == BigRational(0, 7) && !(BigRational(0, 3) < BigRational(0, 7)));
+  CHECK(BigRational(5, 10) == BigRational(1, 2) * BigRational(1));
+  CHECK(BigRational(7) == BigRational(14, 2) && BigRational(14, 2) < BigRational(15, 2));
+}
+
+void CheckFormat() {
+  CHECK(ToString(BigRational(6, 4)) == "3/2");
+  CHECK(ToString(BigRational(8, 4)) == "2");
+  CHECK(ToString(BigRational(-7)) == "-7");
+  CHECK(Parse("7") == BigRational(7));
+  CHECK(Parse("-12/8") == BigRational(-3, 2));
+  CHECK(ToString(Parse("-12/8")) == "-3/2");
+  CHECK(ToString(Parse("10/-4")) == "-5/2");
+
+  std::istringstream is("1/3 -2 4/6");
+  BigRational a, b, c;
+  is >> a >> b >> c;
+  CHECK(a == BigRational(1, 3) && b == BigRational(-2) && c == BigRational(2, 3));
+  CHECK(ToString(a + b + c) == "-1");
+}
+
+// Arithmetic reduces a result only when numerator and denominator have more than 64 digits together;
+// values on both sides of the threshold must behave the same.
+void CheckReductionThreshold() {
+  for (size_t digits = 28; digits <= 36; ++digits) {
+    BigInteger power = Big(std::string(digits + 1, '0').replace(0, 1, "1"));
+    // power / (2 * power) is lazy for 2 * (digits + 1) <= 64 and reduced eagerly above.
+    BigRational half = BigRational(power, power * BigInteger(2)) * BigRational(1);
+    CHECK(half == BigRational(1, 2) && !(half < BigRational(1, 2)) && !(BigRational(1, 2) < half));
+    CHECK(half.Numerator() == BigInteger(1) && half.Denominator() == BigInteger(2));
+    CHECK(ToString(half) == "1/2");
+    CHECK(ToString(half + half) == "1" && half + half == BigRational(1));
+    CHECK(half * BigRational(power) == BigRational(power, BigInteger(2)));
+  }
+
+  // Repeated products of unreduced fractions keep their value whether or not they cross the threshold.
+  BigRational value(1);
+  BigRational step(BigInteger(6), BigInteger(9));
+  for (int i = 0; i < 80; ++i) {
+    value *= step;
+    value /= BigRational(BigInteger(4), BigInteger(6));
+  }
+  CHECK(value == BigRational(1) && ToString(value) == "1");
+}
+
+// Const operations don't write to the object, so threads may share a value which was never reduced.
+void CheckSharedReads() {
+  const BigRational shared = BigRational(BigInteger(123456), BigInteger(246912)) * BigRational(1);
+  const BigRational other(BigInteger(2), BigInteger(4));
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&shared, &other] {
+      for (int i = 0; i < 1000; ++i) {
+        CHECK(shared == other && !(shared < other));
+        CHECK(ToString(shared) == "1/2" && shared.Denominator() == BigInteger(2));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+}
+
+int main() {
+  CheckSigns();
+  CheckComparisons();
+  CheckFormat();
+  CheckReductionThreshold();
+  CheckSharedReads();
+  return 0;
+}
@@ -0,0 +1,28 @@
+#ifndef CHECK_H_
+#define CHECK_H_
+
+#include <cstdio>
+#include <cstdlib>
+
+// Tests are plain executables run by ctest: the first failed check prints its location and exits with status 1.
+// Unlike assert, checks stay active in Release builds.
+#define CHECK(condition)                                                                 \
+  do {                                                                                   \
+    if (!(condition)) {                                                                  \
+      std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #condition); \
+      std::exit(1);                                                                      \
+    }                                                                                    \
+  } while (false)
+
+#define CHECK_THROWS(statement, Exception) \
+  do {                                     \
+    bool is_thrown = false;                \
+    try {                                  \
+      statement;                           \
+    } catch (const Exception &) {          \
+      is_thrown = true;                    \
+    }                                      \
+    CHECK(is_thrown);                      \
+  } while (false)
+
+#endif
@@ -0,0 +1,132 @@
+#include <stddef.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../ConcurrentVector/concurrent_vector.h"
+#include "check.h"
+
+const size_t kProducers = 8;
+const size_t kPerProducer = 20000;
+
+// Producer p pushes p * kPerProducer, ..., (p + 1) * kPerProducer - 1 while a reader walks the vector.
+void CheckConcurrentProducers() {
+  ConcurrentVector<size_t> vector;
+  std::atomic<bool> is_done{false};
+  std::atomic<size_t> passes{0};
+  std::thread reader([&] {
+    while (!is_done.load()) {
+      size_t seen = 0;
+      vector.ForEach([&seen, &vector](size_t index, const size_t &value) {
+        CHECK(value < kProducers * kPerProducer);
+        CHECK(vector.IsPublished(index));
+        ++seen;
+      });
+      CHECK(seen <= vector.Size());
+      ++passes;
+    }
+  });
+  std::vector<std::thread> producers;
+  for (size_t p = 0; p < kProducers; ++p) {
+    producers.emplace_back([&vector, p] {
+      for (size_t i = 0; i < kPerProducer; ++i) {
+        vector.PushBack(p * kPerProducer + i);
+      }
+    });
+  }
+  for (auto &producer : producers) {
+    producer.join();
+  }
+  is_done = true;
+  reader.join();
+  CHECK(passes > 0);
+
+  CHECK(vector.Size() == kProducers * kPerProducer);
+  std::vector<int> counts(kProducers * kPerProducer);
+  std::vector<size_t> last(kProducers, 0);
+  std::vector<bool> has_last(kProducers, false);
+  Vector<size_t> values = vector.ToVector();
+  CHECK(values.Size() == kProducers * kPerProducer);
+  for (size_t i = 0; i < values.Size(); ++i) {
+    CHECK(vector[i] == values[i]);
+    ++counts[values[i]];
+    // Each producer's values keep their order.
+    size_t p = values[i] / kPerProducer;
+    CHECK(!has_last[p] || last[p] < values[i]);
+    last[p] = values[i];
+    has_last[p] = true;
+  }
+  for (int count : counts) {
+    CHECK(count == 1);
+  }
+}
+
+void CheckToVectorMovesOut() {
+  ConcurrentVector<std::string> vector;
+  vector.Reserve(1000);
+  std::vector<std::thread> producers;
+  for (size_t p = 0; p < 4; ++p) {
+    producers.emplace_back([&vector] {
+      for (size_t i = 0; i < 500; ++i) {
+        vector.EmplaceBack(40, 'x');
+      }
+    });
+  }
+  for (auto &producer : producers) {
+    producer.join();
+  }
+  Vector<std::string> copy = vector.ToVector();
+  Vector<std::string> moved = std::move(vector).ToVector();
+  CHECK(copy.Size() == 2000 && moved.Size() == 2000);
+  for (size_t i = 0; i < moved.Size(); ++i) {
+    CHECK(moved[i] == std::string(40, 'x') && copy[i] == moved[i]);
+  }
+}
+
+struct alignas(64) Wide {
+  size_t value;
+};
+
+// Producers start together on empty vectors, so they all need the first segments at once.
+void CheckRacingForSegments() {
+  for (int round = 0; round < 50; ++round) {
+    ConcurrentVector<Wide> vector;
+    std::atomic<bool> is_started{false};
+    std::vector<std::thread> producers;
+    for (size_t p = 0; p < kProducers; ++p) {
+      producers.emplace_back([&vector, &is_started, p] {
+        while (!is_started.load()) {
+          std::this_thread::yield();
+        }
+        for (size_t i = 0; i < 1000; ++i) {
+          vector.PushBack(Wide{p * 1000 + i});
+        }
+      });
+    }
+    is_started = true;
+    for (auto &producer : producers) {
+      producer.join();
+    }
+    std::vector<int> counts(kProducers * 1000);
+    size_t published = 0;
+    vector.ForEach([&counts, &published](size_t, const Wide &element) {
+      CHECK(reinterpret_cast<uintptr_t>(&element) % alignof(Wide) == 0);
+      ++counts[element.value];
+      ++published;
+    });
+    CHECK(published == kProducers * 1000);
+    for (int count : counts) {
+      CHECK(count == 1);
+    }
+  }
+}
+
+int main() {
+  CheckConcurrentProducers();
+  CheckRacingForSegments();
+  CheckToVectorMovesOut();
+  return 0;
+}
@@ -0,0 +1,146 @@
+#include <stddef.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "../Matrix/matrix_serialization.h"
+#include "check.h"
+
+class TemporaryPath {
+ public:
+  TemporaryPath() {
+    char path[] = "/tmp/matrix_serialization_testXXXXXX";
+    int fd = mkstemp(path);
+    CHECK(fd >= 0);
+    close(fd);
+    path_ = path;
+  }
+
+  ~TemporaryPath() {
+    unlink(path_.c_str());
+  }
+
+  const std::string &Get() const {
+    return path_;
+  }
+
+  void Write(const std::string &content) const {
+    std::ofstream file(path_, std::ios::binary | std::ios::trunc);
+    file.write(content.data(), static_cast<std::streamsize>(content.size()));
+  }
+
+ private:
+  std::string path_;
+};
+
+Matrix<double, 3, 4> Sample() {
+  Matrix<double, 3, 4> matrix;
+  for (size_t i = 0; i < 3; ++i) {
+    for (size_t j = 0; j < 4; ++j) {
+      matrix(i, j) = static_cast<double>(i) * 10 + static_cast<double>(j) + 0.25;
+    }
+  }
+  return matrix;
+}
+
+std::string Serialized() {
+  std::ostringstream os;
+  WriteBinary(os, Sample());
+  return os.str();
+}
+
+void CheckRoundTrips() {
+  std::string bytes = Serialized();
+  CHECK(bytes.size() == sizeof(MatrixBinaryHeader) + 12 * sizeof(double));
+
+  std::istringstream is(bytes);
+  Matrix<double, 3, 4> read;
+  ReadBinary(is, read);
+  CHECK(read == Sample());
+
+  TemporaryPath path;
+  path.Write(bytes);
+  MappedMatrix<double> mapped(path.Get());
+  CHECK(mapped.RowsNumber() == 3 && mapped.ColumnsNumber() == 4);
+  CHECK(mapped(2, 3) == 23.25 && mapped.At(1, 0) == 10.25);
+  CHECK_THROWS(mapped.At(3, 0), MatrixOutOfRange);
+  CHECK((mapped.ToMatrix<3, 4>() == Sample()));
+  CHECK_THROWS((mapped.ToMatrix<4, 3>()), MatrixFormatError);
+}
+
+// Rows can be written in several calls, e.g. while they are being computed.
+void CheckStreamingWriter() {
+  std::ostringstream os;
+  MatrixBinaryWriter<int32_t> writer(os, 5, 3);
+  int32_t rows[5][3];
+  for (int32_t i = 0; i < 5; ++i) {
+    for (int32_t j = 0; j < 3; ++j) {
+      rows[i][j] = i * 3 + j - 7;
+    }
+  }
+  writer.WriteRows(rows[0], 2);
+  CHECK(writer.RowsLeft() == 3);
+  writer.WriteRows(rows[2], 1);
+  writer.WriteRows(rows[3], 2);
+  CHECK(writer.RowsLeft() == 0);
+  CHECK_THROWS(writer.WriteRows(rows[0], 1), MatrixFormatError);
+
+  std::istringstream is(os.str());
+  Matrix<int32_t, 5, 3> read;
+  ReadBinary(is, read);
+  CHECK(read(0, 0) == -7 && read(4, 2) == 7 && read(2, 1) == 0);
+
+  TemporaryPath path;
+  path.Write(os.str());
+  MappedMatrix<int32_t> mapped(path.Get());
+  CHECK(mapped.RowsNumber() == 5 && mapped(3, 1) == 3);
+}
+
+template<class Number, size_t N, size_t M>
+void CheckRejected(const std::string &bytes) {
+  std::istringstream is(bytes);
+  Matrix<Number, N, M> matrix;
+  CHECK_THROWS(ReadBinary(is, matrix), MatrixFormatError);
+  TemporaryPath path;
+  path.Write(bytes);
+  CHECK_THROWS(MappedMatrix<Number>(path.Get()), MatrixFormatError);
+}
+
+void CheckRejections() {
+  std::string bytes = Serialized();
+  // Same element size, other type.
+  CheckRejected<int64_t, 3, 4>(bytes);
+  CheckRejected<float, 3, 4>(bytes);
+
+  std::istringstream is(bytes);
+  Matrix<double, 4, 3> transposed;
+  CHECK_THROWS(ReadBinary(is, transposed), MatrixFormatError);
+
+  std::string truncated = bytes.substr(0, bytes.size() - 1);
+  CheckRejected<double, 3, 4>(truncated);
+  CheckRejected<double, 3, 4>(bytes.substr(0, sizeof(MatrixBinaryHeader) - 1));
+
+  std::string swapped = bytes;
+  MatrixBinaryHeader header;
+  std::memcpy(&header, swapped.data(), sizeof(header));
+  header.byte_order = __builtin_bswap32(header.byte_order);
+  std::memcpy(&swapped[0], &header, sizeof(header));
+  CheckRejected<double, 3, 4>(swapped);
+
+  std::string bad_magic = bytes;
+  bad_magic[0] ^= 1;
+  CheckRejected<double, 3, 4>(bad_magic);
+
+  CHECK_THROWS(MappedMatrix<double>("/nonexistent/matrix"), MatrixFileError);
+}
+
+int main() {
+  CheckRoundTrips();
+  CheckStreamingWriter();
+  CheckRejections();
+  return 0;
+}
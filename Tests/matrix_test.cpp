@@ -0,0 +1,317 @@
+#include <stddef.h>
+#include <cstdint>
+#include <random>
+
+#include "../BigRational/big_rational.h"
+#include "../Matrix/matrix.h"
+#include "check.h"
+
+static_assert(AddModulo<uint64_t>(5, 6, 7) == 4);
+static_assert(AddModulo<uint64_t>(0, 0, 1) == 0);
+
+// Moduli above 2^63 make the plain sum of two residues overflow uint64_t.
+void CheckModuloAboveHalfRange() {
+  const uint64_t kModulus = (uint64_t(1) << 63) + 1001;
+  Matrix<uint64_t, 1, 2> row;
+  row(0, 0) = kModulus - 1;
+  row(0, 1) = kModulus - 1;
+  Matrix<uint64_t, 2, 1> column;
+  column(0, 0) = 1;
+  column(1, 0) = 1;
+  CHECK(MultiplyModulo(row, column, kModulus)(0, 0) == kModulus - 2);
+
+  // (-1 -2; -3 -4)^3 = (-37 -54; -81 -118)
+  Matrix<uint64_t, 2, 2> matrix;
+  matrix(0, 0) = kModulus - 1;
+  matrix(0, 1) = kModulus - 2;
+  matrix(1, 0) = kModulus - 3;
+  matrix(1, 1) = kModulus - 4;
+  Matrix<uint64_t, 2, 2> cube = MatrixPow(matrix, 3, kModulus);
+  CHECK(cube(0, 0) == kModulus - 37 && cube(0, 1) == kModulus - 54);
+  CHECK(cube(1, 0) == kModulus - 81 && cube(1, 1) == kModulus - 118);
+}
+
+void CheckModuloPow() {
+  Matrix<int64_t, 2, 2> fibonacci;
+  fibonacci(0, 0) = 1;
+  fibonacci(0, 1) = 1;
+  fibonacci(1, 0) = 1;
+  fibonacci(1, 1) = 0;
+  CHECK(MatrixPow(fibonacci, 90, int64_t(1000000007))(0, 1) == 2880067194370816120LL % 1000000007);
+  CHECK(MatrixPow(fibonacci, 0, int64_t(1))(0, 0) == 0);
+}
+
+template<class Number>
+Number Fibonacci(uint64_t k, Number modulus) {
+  Matrix<Number, 2, 2> fibonacci;
+  fibonacci(0, 0) = 1;
+  fibonacci(0, 1) = 1;
+  fibonacci(1, 0) = 1;
+  fibonacci(1, 1) = 0;
+  return MatrixPow(fibonacci, k, modulus)(0, 1);
+}
+
+// Products of residues overflow Number once the modulus is above the square root of its range.
+void CheckModuloWideProducts() {
+  CHECK(Fibonacci<int64_t>(1000000, 4000000007) == 1572901130);
+  CHECK(Fibonacci<uint64_t>(1000000, 4000000007) == 1572901130);
+  CHECK(Fibonacci<uint32_t>(1000000, 4000000007u) == 1572901130u);
+  CHECK(Fibonacci<int32_t>(1000000, 65537) == 10566);
+  CHECK(Fibonacci<uint16_t>(1000000, 65521) == Fibonacci<uint64_t>(1000000, 65521));
+  CHECK(Fibonacci<int64_t>(1000000000000000000ULL, (int64_t(1) << 62) + 135) == 3186412764851446615LL);
+  CHECK(MultiplyModulo<int64_t>(-3, 5, 7) == 6);
+  static_assert(MultiplyModulo<uint32_t>(4000000006u, 4000000006u, 4000000007u) == 1);
+}
+
+void CheckZeroModulus() {
+  Matrix<uint64_t, 2, 2> matrix = GetIdentity<uint64_t, 2>();
+  CHECK_THROWS(MatrixPow(matrix, 3, uint64_t(0)), MatrixZeroModulus);
+  CHECK_THROWS(MultiplyModulo(matrix, matrix, uint64_t(0)), MatrixZeroModulus);
+}
+
+template<class Number>
+Matrix<Number, 4, 4> RandomMatrix4(std::mt19937_64 &generator) {
+  Matrix<Number, 4, 4> matrix;
+  for (size_t i = 0; i < 4; ++i) {
+    for (size_t j = 0; j < 4; ++j) {
+      matrix(i, j) = static_cast<int64_t>(generator() % 19) - 9;
+    }
+  }
+  return matrix;
+}
+
+constexpr int64_t ConstantDeterminant4() {
+  Matrix<int64_t, 4, 4> matrix{{{2, 0, 0, 1}, {0, 3, 0, 0}, {0, 0, 4, 0}, {1, 0, 0, 5}}};
+  return Determinant(matrix);
+}
+
+static_assert(ConstantDeterminant4() == 108);
+
+// The closed 4x4 forms are checked against cofactor expansion along the first row and against A * A^-1 = I.
+void CheckDeterminantAndInverse4() {
+  std::mt19937_64 generator(4);
+  for (int round = 0; round < 200; ++round) {
+    Matrix<int64_t, 4, 4> matrix = RandomMatrix4<int64_t>(generator);
+    int64_t expansion = 0;
+    for (size_t j = 0; j < 4; ++j) {
+      int64_t minor = Determinant(GetMinor(matrix, 0, j));
+      expansion += (j % 2 == 0 ? 1 : -1) * matrix(0, j) * minor;
+    }
+    CHECK(Determinant(matrix) == expansion);
+  }
+  for (int round = 0; round < 20; ++round) {
+    Matrix<BigRational, 4, 4> matrix = RandomMatrix4<BigRational>(generator);
+    if (Determinant(matrix) == 0) {
+      CHECK_THROWS(GetInversed(matrix), MatrixIsDegenerateError);
+      continue;
+    }
+    Matrix<BigRational, 4, 4> inversed = GetInversed(matrix);
+    Matrix<BigRational, 4, 4> identity = GetIdentity<BigRational, 4>();
+    Matrix<BigRational, 4, 4> product = matrix * inversed;
+    CHECK(product == identity);
+    product = inversed * matrix;
+    CHECK(product == identity);
+  }
+  Matrix<BigRational, 4, 4> degenerate = GetIdentity<BigRational, 4>();
+  degenerate(3, 3) = 0;
+  CHECK_THROWS(GetInversed(degenerate), MatrixIsDegenerateError);
+}
+
+constexpr int64_t ConstantViews() {
+  Matrix<int64_t, 5, 5> matrix{{{2, 1, 0, 0, 0}, {1, 2, 1, 0, 0}, {0, 1, 2, 1, 0}, {0, 0, 1, 2, 1}, {0, 0, 0, 1, 2}}};
+  auto block = GetBlock<3, 3>(matrix, 1, 1);
+  block(0, 0) = 4;
+  return Determinant(matrix) * 1000 + Trace(GetBlock<2, 2>(matrix, 0, 0)) * 10 + GetMinor(matrix, 0, 0)(0, 0);
+}
+
+// The 5x5 tridiagonal (1, 2, 1) matrix with a(1, 1) = 4 has determinant 22; its top left 2x2 block has trace 6.
+static_assert(ConstantViews() == 22064);
+
+void CheckViews() {
+  Matrix<int64_t, 4, 5> matrix;
+  for (size_t i = 0; i < 4; ++i) {
+    for (size_t j = 0; j < 5; ++j) {
+      matrix(i, j) = static_cast<int64_t>(i * 10 + j);
+    }
+  }
+  auto block = GetBlock<2, 3>(matrix, 1, 2);
+  CHECK(block(0, 0) == 12 && block(1, 2) == 24);
+  auto inner = block.Block<1, 2>(1, 1);
+  CHECK(inner(0, 0) == 23 && inner(0, 1) == 24);
+  CHECK(GetRow(matrix, 3)(0, 4) == 34);
+  CHECK(GetColumn(matrix, 4)(2, 0) == 24);
+  CHECK_THROWS((GetBlock<2, 2>(matrix, 3, 0)), MatrixOutOfRange);
+  CHECK_THROWS(block.At(2, 0), MatrixOutOfRange);
+
+  // Minors of blocks, blocks of minors and minors of minors.
+  auto minor = block.Minor(0, 1);
+  CHECK(minor(0, 0) == 22 && minor(0, 1) == 24);
+  auto square = GetMinor(matrix, 1, 0);
+  CHECK(square(0, 0) == 1 && square(1, 0) == 21 && square(2, 3) == 34);
+  auto square_block = square.Block<2, 2>(1, 2);
+  CHECK(square_block(0, 0) == 23 && square_block(1, 1) == 34);
+  CHECK(square.Minor(0, 0).Minor(1, 1)(0, 1) == 24);
+
+  block += GetBlock<2, 3>(matrix, 0, 0);
+  CHECK(matrix(1, 2) == 12 && matrix(2, 4) == 24 + 12);
+  block -= GetBlock<2, 3>(matrix, 0, 0);
+  CHECK(matrix(1, 2) == 12 && matrix(2, 4) == 24);
+  GetRow(matrix, 0) = GetRow(matrix, 3);
+  CHECK(matrix(0, 0) == 30 && matrix(0, 4) == 34);
+  GetMinor(matrix, 0, 0) *= 2;
+  CHECK(matrix(0, 0) == 30 && matrix(1, 1) == 22 && matrix(3, 4) == 68);
+  Matrix<int64_t, 3, 4> copy = GetMinor(matrix, 0, 0);
+  CHECK(copy(2, 3) == 68);
+
+  const Matrix<int64_t, 4, 5> &constant = matrix;
+  auto const_minor = GetMinor(constant, 0, 4);
+  CHECK(const_minor(0, 0) == 10 && const_minor(2, 3) == 66);
+  CHECK(Trace(const_minor.Block<3, 3>(0, 0)) == 10 + 42 + 64);
+  CHECK(Determinant(GetBlock<2, 2>(constant, 0, 0)) == 30 * 22 - 31 * 10);
+}
+
+// One large value followed by ones: float rounds every single 1 added to 1e8 away, wider or compensated sums keep
+// them all, and the pairwise tree loses only what its last merges round off.
+void CheckAccumulationPolicies() {
+  const size_t kCount = 4096;
+  Matrix<float, 1, kCount> row;
+  Matrix<float, kCount, 1> column;
+  for (size_t k = 0; k < kCount; ++k) {
+    row(0, k) = k == 0 ? 1e8f : 1.0f;
+    column(k, 0) = 1.0f;
+  }
+  CHECK(Multiply(PlainAccumulation(), row, column)(0, 0) == 100000000.0f);
+  CHECK(Multiply(WideAccumulation<double>(), row, column)(0, 0) == 100004096.0f);
+  CHECK(Multiply(KahanAccumulation(), row, column)(0, 0) == 100004096.0f);
+  CHECK(Multiply(PairwiseAccumulation(), row, column)(0, 0) == 100004088.0f);
+  CHECK((row * column)(0, 0) == Multiply(PlainAccumulation(), row, column)(0, 0));
+
+  Matrix<float, 64, 64> diagonal = {};
+  for (size_t i = 0; i < 64; ++i) {
+    diagonal(i, i) = i == 0 ? 1e8f : 1.0f;
+  }
+  CHECK(Trace(PlainAccumulation(), diagonal) == 100000000.0f);
+  CHECK(Trace(WideAccumulation<double>(), diagonal) == 100000064.0f);
+  CHECK(Trace(KahanAccumulation(), diagonal) == 100000064.0f);
+  CHECK(Trace(PairwiseAccumulation(), diagonal) == 100000056.0f);
+
+  Matrix<BigRational, 3, 3> fractions = {};
+  for (size_t i = 0; i < 3; ++i) {
+    fractions(i, i) = BigRational(1, static_cast<int64_t>(i) + 2);
+  }
+  CHECK(Trace(PairwiseAccumulation(), fractions) == BigRational(13, 12));
+  CHECK(Trace(KahanAccumulation(), fractions) == Trace(fractions));
+}
+
+// Sizes around kTransposeTileSize and its multiples exercise uneven splits of the recursive blocks.
+template<size_t N, size_t M>
+constexpr Matrix<int64_t, N, M> Numbered() {
+  Matrix<int64_t, N, M> matrix;
+  for (size_t i = 0; i < N; ++i) {
+    for (size_t j = 0; j < M; ++j) {
+      matrix(i, j) = static_cast<int64_t>(i * M + j);
+    }
+  }
+  return matrix;
+}
+
+template<size_t N, size_t M>
+void CheckTransposed() {
+  const Matrix<int64_t, N, M> matrix = Numbered<N, M>();
+  Matrix<int64_t, M, N> transposed = GetTransposed(matrix);
+  for (size_t i = 0; i < N; ++i) {
+    for (size_t j = 0; j < M; ++j) {
+      CHECK(transposed(j, i) == matrix(i, j));
+    }
+  }
+  CHECK(GetTransposed(transposed) == matrix);
+  if constexpr (N == M) {
+    Matrix<int64_t, N, N> in_place = matrix;
+    CHECK(Transpose(in_place) == transposed);
+    CHECK(Transpose(in_place) == matrix);
+  }
+}
+
+constexpr bool ConstantTranspose() {
+  Matrix<int64_t, 33, 33> matrix = Numbered<33, 33>();
+  Transpose(matrix);
+  return matrix == GetTransposed(Numbered<33, 33>()) && GetTransposed(Numbered<20, 35>())(34, 19) == 20 * 35 - 1;
+}
+
+static_assert(ConstantTranspose());
+
+void CheckTranspose() {
+  CheckTransposed<1, 1>();
+  CheckTransposed<17, 17>();
+  CheckTransposed<37, 53>();
+  CheckTransposed<100, 3>();
+  CheckTransposed<100, 100>();
+  CheckTransposed<129, 129>();
+}
+
+// Lazy expressions are checked against element-wise results on an unrolled (N <= kUnrolledMatrixSize) size and a
+// looped one.
+template<size_t N>
+void CheckExpressions(int64_t sum_determinant, int64_t half_determinant) {
+  Matrix<int64_t, N, N> a, b, c;
+  for (size_t i = 0; i < N; ++i) {
+    for (size_t j = 0; j < N; ++j) {
+      a(i, j) = static_cast<int64_t>(i * N + j) + 1;
+      b(i, j) = static_cast<int64_t>((3 * i * i + 5 * j + i * j) % 11) - 5;
+      c(i, j) = static_cast<int64_t>(i) - static_cast<int64_t>(j * j);
+    }
+  }
+
+  Matrix<int64_t, N, N> sum = a + b - c * 2;
+  Matrix<int64_t, N, N> half = (a + b) / 2;
+  for (size_t i = 0; i < N; ++i) {
+    for (size_t j = 0; j < N; ++j) {
+      CHECK(sum(i, j) == a(i, j) + b(i, j) - c(i, j) * 2);
+      CHECK(half(i, j) == (a(i, j) + b(i, j)) / 2);
+    }
+  }
+
+  // Mixed comparisons evaluate the expression side element by element.
+  CHECK(sum == a + b - c * 2 && a + b - c * 2 == sum && !(sum != a + b - c * 2));
+  CHECK(a + b != sum && half != a);
+  CHECK(Trace(a + b - c * 2) == Trace(sum) && Trace(sum) != 0);
+  CHECK(Determinant(a + b - c * 2) == sum_determinant && Determinant(sum) == sum_determinant);
+  CHECK(Determinant((a + b) / 2) == half_determinant && Determinant(half) == half_determinant);
+
+  // The target appears in the expression: element-wise assignment reads each element before writing it, and
+  // products are materialized before the target is overwritten.
+  Matrix<int64_t, N, N> aliased = a;
+  aliased = b - aliased * 2 + aliased;
+  CHECK(aliased == b - a);
+  Matrix<int64_t, N, N> product = a;
+  product *= product + b;
+  CHECK(product == a * (a + b));
+  Matrix<int64_t, N, N> expected;
+  for (size_t i = 0; i < N; ++i) {
+    for (size_t j = 0; j < N; ++j) {
+      expected(i, j) = 0;
+      for (size_t k = 0; k < N; ++k) {
+        expected(i, j) += a(i, k) * (a(k, j) + b(k, j));
+      }
+    }
+  }
+  CHECK(product == expected);
+}
+
+void CheckExpressionTemplates() {
+  CheckExpressions<3>(64, -10);
+  CheckExpressions<6>(471174, 2448);
+}
+
+int main() {
+  CheckViews();
+  CheckDeterminantAndInverse4();
+  CheckModuloAboveHalfRange();
+  CheckModuloPow();
+  CheckModuloWideProducts();
+  CheckZeroModulus();
+  CheckAccumulationPolicies();
+  CheckTranspose();
+  CheckExpressionTemplates();
+  return 0;
+}
@@ -0,0 +1,38 @@
+#include <stddef.h>
+
+#include "../Array/md_array.h"
+#include "check.h"
+
+// Sizes around kMdArrayReductionLanes: arrays smaller than one lane group take the scalar path only.
+template<size_t Size>
+void CheckReduce() {
+  MdArray<int, Size> array;
+  for (size_t i = 0; i < Size; ++i) {
+    array(i) = static_cast<int>(i % 2 == 0 ? i : Size + i);
+  }
+  int sum = 0;
+  int max = 0;
+  for (size_t i = 0; i < Size; ++i) {
+    sum += array(i);
+    max = array(i) > max ? array(i) : max;
+  }
+  CHECK(array.Sum() == sum);
+  CHECK(array.Min() == 0);
+  CHECK(array.Max() == max);
+}
+
+int main() {
+  CheckReduce<1>();
+  CheckReduce<2>();
+  CheckReduce<7>();
+  CheckReduce<8>();
+  CheckReduce<9>();
+  CheckReduce<100>();
+
+  MdArray<double, 3, 2> matrix;
+  matrix.Fill(1.5);
+  matrix(2, 1) = -4;
+  CHECK(matrix.Sum() == 1.5 * 5 - 4);
+  CHECK(matrix.Min() == -4 && matrix.Max() == 1.5);
+  return 0;
+}
@@ -0,0 +1,101 @@
+#include <stddef.h>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "../SparseMatrix/sparse_matrix.h"
+#include "check.h"
+
+void CheckFromTriplets() {
+  // Duplicates are summed, (1, 1) cancels out and is not stored, row 2 is empty.
+  std::vector<Triplet<int64_t>> triplets = {{3, 0, 5}, {0, 2, 1}, {1, 1, 4}, {0, 2, 2}, {1, 1, -4}, {0, 0, 7},
+                                            {3, 3, 0}};
+  SparseMatrix<int64_t> matrix = SparseMatrix<int64_t>::FromTriplets(4, 4, triplets);
+  CHECK(matrix.NonZerosNumber() == 3);
+  CHECK((matrix.RowOffsets() == std::vector<size_t>{0, 2, 2, 2, 3}));
+  CHECK((matrix.ColumnIndices() == std::vector<size_t>{0, 2, 0}));
+  CHECK((matrix.Values() == std::vector<int64_t>{7, 3, 5}));
+  CHECK(matrix.At(0, 2) == 3 && matrix.At(1, 1) == 0 && matrix.At(3, 0) == 5 && matrix.At(2, 3) == 0);
+  CHECK_THROWS(matrix.At(4, 0), SparseMatrixOutOfRange);
+
+  CHECK_THROWS(SparseMatrix<int64_t>::FromTriplets(2, 3, {{2, 0, 1}}), SparseMatrixOutOfRange);
+  CHECK_THROWS(SparseMatrix<int64_t>::FromTriplets(2, 3, {{0, 3, 1}}), SparseMatrixOutOfRange);
+  CHECK(SparseMatrix<int64_t>::FromTriplets(2, 3, {}).NonZerosNumber() == 0);
+}
+
+template<size_t N, size_t M>
+Matrix<int64_t, N, M> RandomSparseDense(std::mt19937_64 &generator) {
+  Matrix<int64_t, N, M> matrix;
+  for (size_t i = 0; i < N; ++i) {
+    for (size_t j = 0; j < M; ++j) {
+      matrix(i, j) = generator() % 4 == 0 ? static_cast<int64_t>(generator() % 21) - 10 : 0;
+    }
+  }
+  // An empty row and an empty column.
+  for (size_t j = 0; j < M; ++j) {
+    matrix(1, j) = 0;
+  }
+  for (size_t i = 0; i < N; ++i) {
+    matrix(i, 2) = 0;
+  }
+  return matrix;
+}
+
+void CheckDenseRoundTripAndProducts() {
+  std::mt19937_64 generator(30);
+  Matrix<int64_t, 7, 5> dense = RandomSparseDense<7, 5>(generator);
+  SparseMatrix<int64_t> sparse = SparseMatrix<int64_t>::FromDense(dense);
+  CHECK((sparse.ToDense<7, 5>() == dense));
+  CHECK_THROWS((sparse.ToDense<5, 7>()), SparseMatrixSizeMismatch);
+
+  std::vector<int64_t> vector = {3, -1, 4, 1, -5};
+  std::vector<int64_t> product = sparse * vector;
+  CHECK(product.size() == 7);
+  for (size_t i = 0; i < 7; ++i) {
+    int64_t expected = 0;
+    for (size_t j = 0; j < 5; ++j) {
+      expected += dense(i, j) * vector[j];
+    }
+    CHECK(product[i] == expected);
+  }
+  CHECK_THROWS(sparse * std::vector<int64_t>(4), SparseMatrixSizeMismatch);
+
+  Matrix<int64_t, 5, 3> right;
+  for (size_t i = 0; i < 5; ++i) {
+    for (size_t j = 0; j < 3; ++j) {
+      right(i, j) = static_cast<int64_t>(i * 3 + j) - 6;
+    }
+  }
+  Matrix<int64_t, 7, 3> expected = dense * right;
+  CHECK((sparse.Multiply<7>(right) == expected));
+  CHECK_THROWS(sparse.Multiply<6>(right), SparseMatrixSizeMismatch);
+}
+
+// The CSR arrays of the transposed matrix are the CSC arrays of the original.
+void CheckTransposed() {
+  std::mt19937_64 generator(31);
+  Matrix<int64_t, 6, 9> dense = RandomSparseDense<6, 9>(generator);
+  SparseMatrix<int64_t> sparse = SparseMatrix<int64_t>::FromDense(dense);
+  SparseMatrix<int64_t> transposed = GetTransposed(sparse);
+  CHECK(transposed.RowsNumber() == 9 && transposed.ColumnsNumber() == 6);
+  CHECK((transposed == SparseMatrix<int64_t>::FromDense(GetTransposed(dense))));
+  CHECK(transposed.RowOffsets()[2] == transposed.RowOffsets()[3]);
+  for (size_t j = 0; j < 9; ++j) {
+    for (size_t k = transposed.RowOffsets()[j]; k + 1 < transposed.RowOffsets()[j + 1]; ++k) {
+      CHECK(transposed.ColumnIndices()[k] < transposed.ColumnIndices()[k + 1]);
+    }
+  }
+  Transpose(transposed);
+  CHECK(transposed == sparse);
+
+  SparseMatrix<int64_t> empty(3, 0);
+  CHECK(GetTransposed(empty).RowsNumber() == 0 && GetTransposed(empty).ColumnsNumber() == 3);
+  CHECK(GetTransposed(SparseMatrix<int64_t>(2, 4)) == SparseMatrix<int64_t>(4, 2));
+}
+
+int main() {
+  CheckFromTriplets();
+  CheckDenseRoundTripAndProducts();
+  CheckTransposed();
+  return 0;
+}
@@ -0,0 +1,34 @@
+#include <stddef.h>
+#include <cstdint>
+#include <memory>
+#include <random>
+
+#include "../Matrix/strassen.h"
+#include "check.h"
+
+template<size_t N>
+void CheckAgainstClassical(size_t cutoff) {
+  std::mt19937_64 generator(N);
+  auto left = std::make_unique<Matrix<int64_t, N, N>>();
+  auto right = std::make_unique<Matrix<int64_t, N, N>>();
+  for (size_t i = 0; i < N; ++i) {
+    for (size_t j = 0; j < N; ++j) {
+      (*left)(i, j) = static_cast<int64_t>(generator() % 201) - 100;
+      (*right)(i, j) = static_cast<int64_t>(generator() % 201) - 100;
+    }
+  }
+  auto expected = std::make_unique<Matrix<int64_t, N, N>>(*left * *right);
+  auto actual = std::make_unique<Matrix<int64_t, N, N>>(StrassenMultiply(*left, *right, cutoff));
+  CHECK(*actual == *expected);
+}
+
+int main() {
+  CheckAgainstClassical<1>(kStrassenCutoff);
+  CheckAgainstClassical<64>(kStrassenCutoff);
+  CheckAgainstClassical<128>(kStrassenCutoff);
+  // Sizes which don't halve evenly are padded.
+  CheckAgainstClassical<100>(16);
+  CheckAgainstClassical<129>(32);
+  CheckAgainstClassical<37>(1);
+  return 0;
+}
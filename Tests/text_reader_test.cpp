@@ -0,0 +1,129 @@
+#include <stddef.h>
+#include <cstdint>
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../TextReader/text_reader.h"
+#include "check.h"
+
+std::FILE *TemporaryFile(const std::string &content) {
+  std::FILE *file = std::tmpfile();
+  CHECK(file != nullptr);
+  CHECK(std::fwrite(content.data(), 1, content.size(), file) == content.size());
+  std::rewind(file);
+  return file;
+}
+
+const std::string kNumbers = "  12345 -678\n+9\t0 -0   4294967296\n  123456789012345678901234567890 7 ";
+
+void CheckNumbers(TextReader &reader) {
+  int value = 0;
+  CHECK(reader.Read(value) && value == 12345);
+  CHECK(reader.Read(value) && value == -678);
+  CHECK(reader.Read(value) && value == 9);
+  CHECK(reader.Read(value) && value == 0);
+  CHECK(reader.Read(value) && value == 0);
+  int64_t wide = 0;
+  CHECK(reader.Read(wide) && wide == 4294967296LL);
+  BigInteger big;
+  CHECK(reader.Read(big));
+  std::ostringstream os;
+  os << big;
+  CHECK(os.str() == "123456789012345678901234567890");
+  CHECK(reader.Read(value) && value == 7);
+  CHECK(!reader.Read(value));
+  CHECK(!reader.Read(value));
+}
+
+// Buffers of 1 to 3 bytes split every token across refills and make the buffer grow.
+void CheckChunkBoundaries() {
+  for (size_t buffer_size = 1; buffer_size <= 3; ++buffer_size) {
+    std::FILE *file = TemporaryFile(kNumbers);
+    TextReader reader(file, buffer_size);
+    CheckNumbers(reader);
+    std::fclose(file);
+  }
+  std::FILE *file = TemporaryFile(kNumbers);
+  TextReader reader(file);
+  CheckNumbers(reader);
+  std::fclose(file);
+}
+
+void CheckFromMemory() {
+  TextReader reader = TextReader::FromMemory(kNumbers.data(), kNumbers.size());
+  CheckNumbers(reader);
+
+  std::string doubles = "1.5 -2.25e3 +0.125";
+  TextReader double_reader = TextReader::FromMemory(doubles.data(), doubles.size());
+  std::vector<double> values;
+  CHECK(double_reader.ReadAll(values) == 3);
+  CHECK(values[0] == 1.5 && values[1] == -2250 && values[2] == 0.125);
+
+  TextReader empty = TextReader::FromMemory(doubles.data(), 0);
+  double value = 0;
+  CHECK(!empty.Read(value));
+}
+
+void CheckMalformed() {
+  for (const char *token : {"12a", "+-3", "--1", "+", "-", "1.5", "99999999999", "x"}) {
+    std::string text = std::string("1 ") + token + " 2";
+    TextReader reader = TextReader::FromMemory(text.data(), text.size());
+    int value = 0;
+    CHECK(reader.Read(value) && value == 1);
+    CHECK_THROWS(reader.Read(value), TextReaderParseError);
+  }
+  for (const char *token : {"12a", "+-3", "-", "1-2"}) {
+    std::string text(token);
+    TextReader reader = TextReader::FromMemory(text.data(), text.size());
+    BigInteger value;
+    CHECK_THROWS(reader.Read(value), TextReaderParseError);
+  }
+  CHECK_THROWS(TextReader("/nonexistent/text_reader_test"), TextReaderFileError);
+}
+
+void CheckMatrix() {
+  std::string text = "1 2 3\n4 5 6\n7";
+  TextReader reader = TextReader::FromMemory(text.data(), text.size());
+  Matrix<int, 2, 3> matrix;
+  CHECK(reader.Read(matrix));
+  CHECK(matrix(0, 0) == 1 && matrix(1, 2) == 6);
+  Matrix<int, 2, 2> rest;
+  CHECK(!reader.Read(rest));
+  CHECK(rest(0, 0) == 7);
+
+  std::FILE *file = TemporaryFile(text);
+  TextReader file_reader(file, 2);
+  CHECK(file_reader.Read(matrix));
+  CHECK(matrix(0, 1) == 2 && matrix(1, 0) == 4);
+  CHECK(!file_reader.Read(rest));
+  std::fclose(file);
+}
+
+// Numbers are parsed from the digits the token starts with; leading zeros don't count towards the digit limit.
+void CheckBigIntegerLimits() {
+  std::string zeros = std::string(40000, '0') + "17";
+  TextReader reader = TextReader::FromMemory(zeros.data(), zeros.size());
+  BigInteger value;
+  CHECK(reader.Read(value) && value == 17);
+  std::string huge(40000, '9');
+  TextReader huge_reader = TextReader::FromMemory(huge.data(), huge.size());
+  CHECK_THROWS(huge_reader.Read(value), BigIntegerOverflow);
+  for (size_t length = 1; length <= 7; ++length) {
+    std::string digits = "-" + std::string(length, '8');
+    BigInteger parsed(digits.c_str());
+    std::ostringstream os;
+    os << parsed;
+    CHECK(os.str() == digits);
+  }
+}
+
+int main() {
+  CheckChunkBoundaries();
+  CheckFromMemory();
+  CheckMalformed();
+  CheckMatrix();
+  CheckBigIntegerLimits();
+  return 0;
+}
@@ -0,0 +1,127 @@
+#include <stddef.h>
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+#include "../Matrix/parallel_matrix.h"
+#include "../Matrix/thread_pool.h"
+#include "check.h"
+
+void CheckParallelForCoversRange(ThreadPool &pool) {
+  for (size_t size : {0, 1, 7, 1000, 100003}) {
+    std::vector<std::atomic<int>> visits(size);
+    pool.ParallelFor(size, 16, [&visits](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        ++visits[i];
+      }
+    });
+    for (auto &visit : visits) {
+      CHECK(visit == 1);
+    }
+  }
+}
+
+void CheckParallelForRethrows(ThreadPool &pool) {
+  std::atomic<size_t> done{0};
+  CHECK_THROWS(pool.ParallelFor(64, 64, [&done](size_t begin, size_t) {
+    if (begin == 13) {
+      throw std::runtime_error("chunk");
+    }
+    ++done;
+  }), std::runtime_error);
+  CHECK(done == 63);
+}
+
+// Copies of the body are made while chunks are submitted; one of them failing must not leave the caller waiting
+// for chunks which were never queued.
+struct ThrowingCopyBody {
+  static int copies_left;
+
+  std::atomic<size_t> *done;
+
+  explicit ThrowingCopyBody(std::atomic<size_t> *done) : done(done) {
+  }
+
+  ThrowingCopyBody(const ThrowingCopyBody &other) : done(other.done) {
+    if (copies_left-- == 0) {
+      throw std::length_error("copy");
+    }
+  }
+
+  void operator()(size_t begin, size_t end) const {
+    *done += end - begin;
+  }
+};
+
+int ThrowingCopyBody::copies_left = 0;
+
+void CheckParallelForSubmitFailure(ThreadPool &pool) {
+  std::atomic<size_t> done{0};
+  ThrowingCopyBody body(&done);
+  ThrowingCopyBody::copies_left = 10;
+  CHECK_THROWS(pool.ParallelFor(1000, 100, body), std::length_error);
+  CHECK(done < 1000);
+  ThrowingCopyBody::copies_left = 1 << 30;
+  done = 0;
+  pool.ParallelFor(1000, 100, body);
+  CHECK(done == 1000);
+}
+
+void CheckNestedParallelFor(ThreadPool &pool) {
+  std::atomic<size_t> sum{0};
+  pool.ParallelFor(8, 8, [&pool, &sum](size_t, size_t) {
+    pool.ParallelFor(100, 10, [&sum](size_t begin, size_t end) {
+      sum += end - begin;
+    });
+  });
+  CHECK(sum == 800);
+}
+
+void CheckSubmit(ThreadPool &pool) {
+  std::atomic<int> counter{0};
+  for (int i = 0; i < 1000; ++i) {
+    pool.Submit([&counter] {
+      ++counter;
+    });
+  }
+  // Waiting on an empty ParallelFor doesn't wait for Submit'ed tasks, so spin on the counter.
+  while (counter != 1000) {
+    std::this_thread::yield();
+  }
+}
+
+void CheckParallelPolicy(ThreadPool &pool) {
+  static Matrix<int64_t, 200, 300> left;
+  static Matrix<int64_t, 300, 100> right;
+  for (size_t i = 0; i < 200; ++i) {
+    for (size_t j = 0; j < 300; ++j) {
+      left(i, j) = static_cast<int64_t>((i * 31 + j * 17) % 23) - 11;
+    }
+  }
+  for (size_t i = 0; i < 300; ++i) {
+    for (size_t j = 0; j < 100; ++j) {
+      right(i, j) = static_cast<int64_t>((i * 7 + j * 13) % 19) - 9;
+    }
+  }
+  MatrixParallelPolicy policy(pool, 1);
+  static Matrix<int64_t, 200, 100> expected;
+  static Matrix<int64_t, 200, 100> actual;
+  expected = left * right;
+  actual = Multiply(policy, left, right);
+  CHECK(actual == expected);
+  CHECK(Add(policy, left, left) == Add(MatrixSequencedPolicy(), left, left));
+}
+
+int main() {
+  for (size_t threads : {1, 4}) {
+    ThreadPool pool(threads);
+    CHECK(pool.ThreadsNumber() == threads);
+    CheckParallelForCoversRange(pool);
+    CheckParallelForRethrows(pool);
+    CheckParallelForSubmitFailure(pool);
+    CheckNestedParallelFor(pool);
+    CheckSubmit(pool);
+    CheckParallelPolicy(pool);
+  }
+  return 0;
+}
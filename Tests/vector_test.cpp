@@ -0,0 +1,129 @@
+#include <stddef.h>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "../Vector/vector.h"
+#include "check.h"
+
+// Counts live instances and throws from the copy constructor once copies_left reaches zero.
+struct Tracked {
+  static int alive;
+  static int copies_left;
+
+  int value;
+
+  explicit Tracked(int value) : value(value) {
+    ++alive;
+  }
+
+  Tracked(const Tracked &other) : value(other.value) {
+    if (copies_left-- == 0) {
+      throw std::runtime_error("Tracked");
+    }
+    ++alive;
+  }
+
+  ~Tracked() {
+    --alive;
+  }
+};
+
+int Tracked::alive = 0;
+int Tracked::copies_left = 1 << 30;
+
+void CheckPushBackAndGrowth() {
+  Vector<int> vector;
+  CHECK(vector.Empty());
+  for (int i = 0; i < 100000; ++i) {
+    vector.PushBack(i);
+  }
+  CHECK(vector.Size() == 100000);
+  CHECK(vector.Capacity() >= vector.Size());
+  for (int i = 0; i < 100000; ++i) {
+    CHECK(vector[i] == i);
+  }
+  vector.PopBack();
+  CHECK(vector.Size() == 99999);
+  vector.ShrinkToFit();
+  CHECK(vector.Capacity() == 99999);
+  CHECK(vector[99998] == 99998);
+  vector.Clear();
+  CHECK(vector.Empty());
+}
+
+void CheckCopyAndMove() {
+  Vector<std::string> vector;
+  for (int i = 0; i < 1000; ++i) {
+    vector.EmplaceBack(std::to_string(i));
+  }
+  Vector<std::string> copy = vector;
+  CHECK(copy.Size() == 1000 && copy[999] == "999");
+  Vector<std::string> assigned{"a", "b"};
+  assigned = vector;
+  CHECK(assigned.Size() == 1000 && assigned[500] == "500");
+  Vector<std::string> moved = std::move(copy);
+  CHECK(moved.Size() == 1000 && moved[1] == "1");
+  assigned = std::move(moved);
+  CHECK(assigned.Size() == 1000 && assigned[0] == "0");
+
+  size_t sum = 0;
+  for (const auto &element : vector) {
+    sum += element.size();
+  }
+  CHECK(sum == 10 + 90 * 2 + 900 * 3);
+}
+
+// EmplaceBack may get its argument from the vector itself.
+void CheckSelfReference() {
+  Vector<std::string> vector{"self"};
+  for (int i = 0; i < 100; ++i) {
+    vector.PushBack(vector[0]);
+  }
+  CHECK(vector.Size() == 101 && vector[100] == "self");
+}
+
+void CheckStrongGuarantee() {
+  {
+    Vector<Tracked> vector;
+    vector.Reserve(4);
+    for (int i = 0; i < 4; ++i) {
+      vector.EmplaceBack(i);
+    }
+    Tracked::copies_left = 2;
+    CHECK_THROWS(vector.PushBack(Tracked(4)), std::runtime_error);
+    Tracked::copies_left = 1 << 30;
+    CHECK(vector.Size() == 4 && vector.Capacity() == 4);
+    for (int i = 0; i < 4; ++i) {
+      CHECK(vector[i].value == i);
+    }
+  }
+  CHECK(Tracked::alive == 0);
+}
+
+// Above Vector's mapping threshold storage comes from mmap and grows with mremap.
+void CheckHugeStorage() {
+  Vector<long long> vector;
+  const size_t kSize = (size_t(1) << 22) + 3;
+  for (size_t i = 0; i < kSize; ++i) {
+    vector.PushBack(static_cast<long long>(i));
+  }
+  CHECK(vector.Size() == kSize);
+  for (size_t i = 0; i < kSize; i += 4099) {
+    CHECK(vector[i] == static_cast<long long>(i));
+  }
+  Vector<long long> copy = vector;
+  CHECK(copy[kSize - 1] == static_cast<long long>(kSize - 1));
+  vector.ShrinkToFit();
+  CHECK(vector.Capacity() == kSize && vector[kSize - 1] == static_cast<long long>(kSize - 1));
+}
+
+int main() {
+  CheckPushBackAndGrowth();
+  CheckCopyAndMove();
+  CheckSelfReference();
+  CheckStrongGuarantee();
+  CheckHugeStorage();
+  return 0;
+}
@@ -0,0 +1,213 @@
+#ifndef TEXT_READER_H_
+#define TEXT_READER_H_
+
+#include <stddef.h>
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "../BigInteger/big_integer.h"
+#include "../Matrix/matrix.h"
+
+class TextReaderFileError : public std::runtime_error {
+ public:
+  explicit TextReaderFileError(const std::string &path) : std::runtime_error("TextReaderFileError: " + path) {
+  }
+};
+
+class TextReaderParseError : public std::runtime_error {
+ public:
+  TextReaderParseError() : std::runtime_error("TextReaderParseError") {
+  }
+};
+
+// Reads whitespace-separated tokens from a file in large chunks, or from a buffer already in memory
+// (e.g. a memory-mapped file), and parses them with std::from_chars, bypassing iostream locales and sentries.
+// Every byte not greater than ' ' is treated as whitespace.
+class TextReader {
+ public:
+  static const size_t kDefaultBufferSize = 1 << 20;
+
+  explicit TextReader(const std::string &path, size_t buffer_size = kDefaultBufferSize)
+      : file_(std::fopen(path.c_str(), "rb")), owns_file_(true), buffer_(std::max<size_t>(buffer_size, 1)) {
+    if (file_ == nullptr) {
+      throw TextReaderFileError(path);
+    }
+    current_ = end_ = buffer_.data();
+  }
+
+  explicit TextReader(std::FILE *file, size_t buffer_size = kDefaultBufferSize)
+      : file_(file), owns_file_(false), buffer_(std::max<size_t>(buffer_size, 1)) {
+    current_ = end_ = buffer_.data();
+  }
+
+  // The data must outlive the reader.
+  static TextReader FromMemory(const char *data, size_t size) {
+    return TextReader(data, data + size);
+  }
+
+  TextReader(const TextReader &) = delete;
+  TextReader &operator=(const TextReader &) = delete;
+
+  ~TextReader() {
+    if (owns_file_) {
+      std::fclose(file_);
+    }
+  }
+
+  // Returns false when there are no tokens left. The token stays valid until the next call.
+  bool NextToken(const char *&begin, const char *&end) {
+    current_ = SkipWhitespace(current_, end_);
+    while (current_ == end_) {
+      if (!Refill()) {
+        return false;
+      }
+      current_ = SkipWhitespace(current_, end_);
+    }
+    const char *token_end = FindWhitespace(current_, end_);
+    while (token_end == end_) {
+      bool refilled = Refill();
+      token_end = FindWhitespace(current_, end_);
+      if (!refilled) {
+        break;
+      }
+    }
+    begin = current_;
+    end = token_end;
+    current_ = token_end;
+    return true;
+  }
+
+  template<class Number, class = std::enable_if_t<std::is_arithmetic<Number>::value &&
+      !std::is_same<Number, bool>::value>>
+  bool Read(Number &value) {
+    const char *begin = nullptr;
+    const char *end = nullptr;
+    if (!NextToken(begin, end)) {
+      return false;
+    }
+    if (*begin == '+' && end - begin > 1 && *(begin + 1) != '-') {
+      ++begin;
+    }
+    std::from_chars_result result = std::from_chars(begin, end, value);
+    if (result.ec != std::errc() || result.ptr != end) {
+      throw TextReaderParseError();
+    }
+    return true;
+  }
+
+  bool Read(BigInteger &value) {
+    const char *begin = nullptr;
+    const char *end = nullptr;
+    if (!NextToken(begin, end)) {
+      return false;
+    }
+    try {
+      value = BigInteger(begin, end);
+    } catch (const std::invalid_argument &) {
+      throw TextReaderParseError();
+    }
+    return true;
+  }
+
+  // Returns false if the input ends before the whole matrix is read.
+  template<class Number, size_t N, size_t M>
+  bool Read(Matrix<Number, N, M> &matrix) {
+    for (size_t i = 0; i < N; ++i) {
+      for (size_t j = 0; j < M; ++j) {
+        if (!Read(matrix(i, j))) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  template<class T>
+  size_t ReadAll(std::vector<T> &values) {
+    size_t count = 0;
+    T value;
+    while (Read(value)) {
+      values.push_back(value);
+      ++count;
+    }
+    return count;
+  }
+
+ private:
+  std::FILE *file_;
+  bool owns_file_;
+  std::vector<char> buffer_;
+  const char *current_;
+  const char *end_;
+
+  TextReader(const char *begin, const char *end) : file_(nullptr), owns_file_(false), current_(begin), end_(end) {
+  }
+
+  // Moves the unread tail to the front of the buffer and appends the next chunk of the file.
+  // A token which fills the whole buffer makes it grow.
+  bool Refill() {
+    if (file_ == nullptr) {
+      return false;
+    }
+    size_t left = end_ - current_;
+    std::memmove(buffer_.data(), current_, left);
+    if (left == buffer_.size()) {
+      buffer_.resize(buffer_.size() * 2);
+    }
+    size_t read = std::fread(buffer_.data() + left, 1, buffer_.size() - left, file_);
+    current_ = buffer_.data();
+    end_ = buffer_.data() + left + read;
+    return read != 0;
+  }
+
+  static const char *SkipWhitespace(const char *begin, const char *end) {
+#ifdef __SSE2__
+    const __m128i flip = _mm_set1_epi8(static_cast<char>(0x80));
+    const __m128i space = _mm_set1_epi8(static_cast<char>(' ' ^ 0x80));
+    while (end - begin >= 16) {
+      __m128i chunk = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(begin)), flip);
+      int mask = _mm_movemask_epi8(_mm_cmpgt_epi8(chunk, space));
+      if (mask != 0) {
+        return begin + __builtin_ctz(mask);
+      }
+      begin += 16;
+    }
+#endif
+    while (begin != end && static_cast<unsigned char>(*begin) <= ' ') {
+      ++begin;
+    }
+    return begin;
+  }
+
+  static const char *FindWhitespace(const char *begin, const char *end) {
+#ifdef __SSE2__
+    const __m128i flip = _mm_set1_epi8(static_cast<char>(0x80));
+    const __m128i space = _mm_set1_epi8(static_cast<char>(' ' ^ 0x80));
+    while (end - begin >= 16) {
+      __m128i chunk = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(begin)), flip);
+      int mask = _mm_movemask_epi8(_mm_cmpgt_epi8(chunk, space)) ^ 0xffff;
+      if (mask != 0) {
+        return begin + __builtin_ctz(mask);
+      }
+      begin += 16;
+    }
+#endif
+    while (begin != end && static_cast<unsigned char>(*begin) > ' ') {
+      ++begin;
+    }
+    return begin;
+  }
+};
+
+#endif
@@ -1,154 +1,233 @@
 #ifndef VECTOR_H_
 #define VECTOR_H_
 
+#include <stddef.h>
+#include <algorithm>
+#include <cstring>
+#include <initializer_list>
 #include <iostream>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
+#include "../Instrumentation/instrumentation.h"
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
 template<class T>
 class Vector {
  public:
-  class Iterator {
+  // Contiguous iterator over Value (T or const T); Iterator converts to ConstIterator.
+  template<class Value>
+  class BasicIterator {
    private:
-    T *current_ = nullptr;
-    
+    Value *current_ = nullptr;
+
    public:
-    Iterator() {
+    using iterator_category = std::random_access_iterator_tag;
+#if __cplusplus >= 202002L
+    using iterator_concept = std::contiguous_iterator_tag;
+#endif
+    using value_type = std::remove_cv_t<Value>;
+    using element_type = Value;
+    using difference_type = std::ptrdiff_t;
+    using pointer = Value *;
+    using reference = Value &;
+
+    BasicIterator() {
     }
 
-    explicit Iterator(T *p_int) {
-      current_ = p_int;
+    explicit BasicIterator(Value *current) : current_(current) {
     }
 
-    Iterator &operator=(const Iterator &iterator) {
-      current_ = iterator.current_;
-      return *this;
+    template<class Other, class = std::enable_if_t<std::is_convertible<Other *, Value *>::value>>
+    BasicIterator(const BasicIterator<Other> &iterator) : current_(iterator.operator->()) {  // NOLINT
     }
 
-    Iterator &operator+=(int step) {
+    BasicIterator &operator+=(difference_type step) {
       current_ += step;
       return *this;
     }
 
-    Iterator &operator-=(int step) {
+    BasicIterator &operator-=(difference_type step) {
       current_ -= step;
       return *this;
     }
 
-    Iterator operator+(int step) const {
-      Iterator result = *this;
-      result += step;
-      return result;
+    BasicIterator operator+(difference_type step) const {
+      return BasicIterator(current_ + step);
     }
 
-    Iterator operator-(int step) const {
-      Iterator result = *this;
-      return result -= step;
+    friend BasicIterator operator+(difference_type step, const BasicIterator &iterator) {
+      return iterator + step;
     }
 
-    size_t operator-(const Iterator &iterator) {
-      return current_ - iterator.current_;
+    BasicIterator operator-(difference_type step) const {
+      return BasicIterator(current_ - step);
     }
 
-    size_t operator+(const Iterator &iterator) {
-      return current_ + iterator.current_;
+    difference_type operator-(const BasicIterator &iterator) const {
+      return current_ - iterator.current_;
     }
 
-    Iterator &operator++() {
-      return *this += 1;
+    BasicIterator &operator++() {
+      ++current_;
+      return *this;
     }
 
-    Iterator &operator--() {
-      current_ -= 1;
+    BasicIterator &operator--() {
+      --current_;
       return *this;
     }
 
-    Iterator operator++(int) {
-      Iterator curr = *(this);
-      ++(*this);
+    BasicIterator operator++(int) {
+      BasicIterator curr = *this;
+      ++current_;
       return curr;
     }
 
-    Iterator operator--(int) {
-      Iterator curr = *(this);
-      --(*this);
+    BasicIterator operator--(int) {
+      BasicIterator curr = *this;
+      --current_;
       return curr;
     }
 
-    T operator*() {
+    Value &operator*() const {
       return *current_;
     }
 
-    T *operator->() {
+    Value *operator->() const {
       return current_;
     }
 
-    bool operator==(const Iterator &other) const {
+    Value &operator[](difference_type index) const {
+      return current_[index];
+    }
+
+    bool operator==(const BasicIterator &other) const {
       return current_ == other.current_;
     }
 
-    bool operator!=(const Iterator &other) const {
+    bool operator!=(const BasicIterator &other) const {
       return current_ != other.current_;
     }
+
+    bool operator<(const BasicIterator &other) const {
+      return current_ < other.current_;
+    }
+
+    bool operator>(const BasicIterator &other) const {
+      return current_ > other.current_;
+    }
+
+    bool operator<=(const BasicIterator &other) const {
+      return current_ <= other.current_;
+    }
+
+    bool operator>=(const BasicIterator &other) const {
+      return current_ >= other.current_;
+    }
   };
 
+  using Iterator = BasicIterator<T>;
+  using ConstIterator = BasicIterator<const T>;
+
   Vector() {
-    Reserve(1);
   }
 
   explicit Vector(size_t size) {
-    Realloc(size);
-    for (size_t i = 0; i < size; ++i) {
-      *(data_ + i) = 0;
+    T *data = Allocate(size);
+    try {
+      std::uninitialized_value_construct_n(data, size);
+    } catch (...) {
+      Deallocate(data, size);
+      throw;
     }
+    data_ = data;
     size_ = size;
-    capacity_ = size_;
+    capacity_ = size;
   }
 
-  Vector(std::initializer_list<int> list) {
-    Realloc(list.size());
-    for (size_t i = 0; i < list.size(); ++i) {
-      *(data_ + i) = *(list.begin() + i);
+  Vector(std::initializer_list<T> list) {
+    T *data = Allocate(list.size());
+    try {
+      CopyElements(list.begin(), list.size(), data);
+    } catch (...) {
+      Deallocate(data, list.size());
+      throw;
     }
+    data_ = data;
     size_ = list.size();
     capacity_ = size_;
   }
 
   Vector(const Vector &vector) {
-    Reserve(vector.capacity_);
-    for (size_t i = 0; i < vector.size_; ++i) {
-      *(data_ + i) = *(vector.data_ + i);
+    T *data = Allocate(vector.size_);
+    try {
+      CopyElements(vector.data_, vector.size_, data);
+    } catch (...) {
+      Deallocate(data, vector.size_);
+      throw;
     }
+    data_ = data;
     size_ = vector.size_;
-    capacity_ = vector.capacity_;
+    capacity_ = size_;
   }
 
-  Vector(Vector &&vector) {
-    data_ = vector.data_;
-    capacity_ = vector.size_;
-    size_ = vector.size_;
+  Vector(Vector &&vector) noexcept : data_(vector.data_), size_(vector.size_), capacity_(vector.capacity_) {
     vector.data_ = nullptr;
+    vector.size_ = 0;
+    vector.capacity_ = 0;
   }
 
-  Vector &operator=(Vector vector) {
-    Reserve(vector.capacity_);
-    for (size_t i = 0; i < vector.size_; ++i) {
-      *(data_ + i) = *(vector.data_ + i);
+  // Reuses the existing storage when it is large enough: common elements are copy-assigned, the rest is constructed
+  // or destroyed.
+  Vector &operator=(const Vector &vector) {
+    if (this == &vector) {
+      return *this;
+    }
+    if (vector.size_ > capacity_) {
+      Vector copy(vector);
+      Swap(copy);
+      return *this;
+    }
+    if constexpr (std::is_trivially_copyable<T>::value) {
+      CopyElements(vector.data_, vector.size_, data_);
+    } else {
+      size_t common = std::min(size_, vector.size_);
+      INSTRUMENT_COPY("Vector", common * sizeof(T));
+      std::copy(vector.data_, vector.data_ + common, data_);
+      if (vector.size_ > size_) {
+        CopyElements(vector.data_ + size_, vector.size_ - size_, data_ + size_);
+      } else {
+        std::destroy_n(data_ + vector.size_, size_ - vector.size_);
+      }
     }
     size_ = vector.size_;
-    capacity_ = vector.capacity_;
+    return *this;
+  }
+
+  Vector &operator=(Vector &&vector) noexcept {
+    Vector moved(std::move(vector));
+    Swap(moved);
     return *this;
   }
 
   ~Vector() {
-    delete[] data_;
+    std::destroy_n(data_, size_);
+    Deallocate(data_, capacity_);
   }
 
   T &operator[](size_t index) {
     return *(data_ + index);
   }
 
-  T operator[](size_t index) const {
+  const T &operator[](size_t index) const {
     return *(data_ + index);
   }
 
@@ -160,44 +239,89 @@ class Vector {
     return capacity_;
   }
 
-  void Swap(Vector &vector) {
+  void Swap(Vector &vector) noexcept {
     std::swap(data_, vector.data_);
     std::swap(capacity_, vector.capacity_);
     std::swap(size_, vector.size_);
   }
 
-  void PushBack(T element) {
-    if (capacity_ >= size_ + 1) {
-      *(data_ + size_) = element;
-      ++size_;
+  void PushBack(const T &element) {
+    EmplaceBack(element);
+  }
+
+  void PushBack(T &&element) {
+    EmplaceBack(std::move(element));
+  }
+
+  // The new element is constructed before the old ones are moved, so arguments may refer to elements of the vector.
+  template<class... Args>
+  T &EmplaceBack(Args &&... args) {
+    INSTRUMENT_CALL("Vector", "EmplaceBack");
+    if (size_ < capacity_) {
+      new (data_ + size_) T(std::forward<Args>(args)...);
+    } else if (IsMapped(capacity_)) {
+      // mremap may move the storage, so the element is built before growing.
+      T element(std::forward<Args>(args)...);
+      Realloc(capacity_ * 2);
+      new (data_ + size_) T(std::move(element));
     } else {
-      Reserve(size_ * 2);
-      *(data_ + size_) = element;
-      ++size_;
+      size_t new_capacity = capacity_ == 0 ? 1 : capacity_ * 2;
+      T *data = Allocate(new_capacity);
+      try {
+        new (data + size_) T(std::forward<Args>(args)...);
+      } catch (...) {
+        Deallocate(data, new_capacity);
+        throw;
+      }
+      try {
+        MoveElements(data);
+      } catch (...) {
+        data[size_].~T();
+        Deallocate(data, new_capacity);
+        throw;
+      }
+      Replace(data, new_capacity);
     }
+    return data_[size_++];
   }
 
-  bool Empty() {
+  bool Empty() const {
     return size_ == 0;
   }
 
   void PopBack() {
     if (!Empty()) {
       --size_;
+      data_[size_].~T();
     }
   }
 
   void Clear() {
+    std::destroy_n(data_, size_);
     size_ = 0;
   }
 
   void Reserve(size_t size) {
     if (capacity_ < size) {
       Realloc(size);
-      capacity_ = size;
     }
   }
 
+  // Releases unused capacity. Mapped storage is shrunk in place, so the tail pages go back to the OS without a copy.
+  void ShrinkToFit() {
+    if (capacity_ > size_) {
+      Realloc(size_);
+    }
+  }
+
+  T *Data() {
+    return data_;
+  }
+
+  const T *Data() const {
+    return data_;
+  }
+
   Iterator Begin() {
     return Iterator(data_);
   }
@@ -206,32 +330,154 @@ class Vector {
     return Iterator(data_ + size_);
   }
 
-  Iterator begin() {// NOLINT
+  ConstIterator Begin() const {
+    return ConstIterator(data_);
+  }
+
+  ConstIterator End() const {
+    return ConstIterator(data_ + size_);
+  }
+
+  Iterator begin() {  // NOLINT
     return Iterator(data_);
   }
 
-  Iterator end() {// NOLINT
+  Iterator end() {  // NOLINT
     return Iterator(data_ + size_);
   }
 
+  ConstIterator begin() const {  // NOLINT
+    return ConstIterator(data_);
+  }
+
+  ConstIterator end() const {  // NOLINT
+    return ConstIterator(data_ + size_);
+  }
+
   private:
   T *data_ = nullptr;
   size_t size_ = 0;
   size_t capacity_ = 0;
 
-  void Realloc(size_t new_size) {
-    if (capacity_ == 0) {
-      data_ = new T[new_size];
-      capacity_ = new_size;
+  // Storage of at least kHugeAllocationSize bytes of trivially copyable elements is mapped straight from the OS
+  // and backed by transparent huge pages. Such elements may be relocated by the kernel, so growth and ShrinkToFit
+  // resize the mapping with mremap instead of allocating a second block and copying into it.
+  static constexpr size_t kHugeAllocationSize = size_t(1) << 25;
+  static constexpr size_t kHugePageSize = size_t(1) << 21;
+
+  static bool IsMapped(size_t capacity) {
+#ifdef __linux__
+    return std::is_trivially_copyable<T>::value && alignof(T) <= 4096 && capacity >= kHugeAllocationSize / sizeof(T);
+#else
+    return false;
+#endif
+  }
+
+  static size_t MappedBytes(size_t capacity) {
+    return (capacity * sizeof(T) + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+  }
+
+  static T *Allocate(size_t capacity) {
+    if (capacity == 0) {
+      return nullptr;
+    }
+    INSTRUMENT_ALLOCATION("Vector", capacity * sizeof(T));
+#ifdef __linux__
+    if (IsMapped(capacity)) {
+      void *data = mmap(nullptr, MappedBytes(capacity), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (data == MAP_FAILED) {
+        throw std::bad_alloc();
+      }
+      AdviseHugePages(data, MappedBytes(capacity));
+      return static_cast<T *>(data);
+    }
+#endif
+    return static_cast<T *>(::operator new(capacity * sizeof(T), std::align_val_t(alignof(T))));
+  }
+
+  static void Deallocate(T *data, size_t capacity) {
+    if (data == nullptr) {
+      return;
+    }
+#ifdef __linux__
+    if (IsMapped(capacity)) {
+      munmap(data, MappedBytes(capacity));
+      return;
+    }
+#endif
+    ::operator delete(data, std::align_val_t(alignof(T)));
+  }
+
+  static void AdviseHugePages(void *data, size_t bytes) {
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    madvise(data, bytes, MADV_HUGEPAGE);
+#endif
+  }
+
+  void Remap(size_t new_capacity) {
+#ifdef __linux__
+    INSTRUMENT_CALL("Vector", "mremap");
+    void *data = mremap(data_, MappedBytes(capacity_), MappedBytes(new_capacity), MREMAP_MAYMOVE);
+    if (data == MAP_FAILED) {
+      throw std::bad_alloc();
+    }
+    AdviseHugePages(data, MappedBytes(new_capacity));
+    data_ = static_cast<T *>(data);
+    capacity_ = new_capacity;
+#endif
+  }
+
+  // Copies into uninitialized storage; trivially copyable elements are copied as raw bytes.
+  static void CopyElements(const T *source, size_t count, T *data) {
+    INSTRUMENT_COPY("Vector", count * sizeof(T));
+    if constexpr (std::is_trivially_copyable<T>::value) {
+      if (count != 0) {
+        std::memcpy(data, source, count * sizeof(T));
+      }
     } else {
-      auto copy = new T[new_size];
+      std::uninitialized_copy(source, source + count, data);
+    }
+  }
 
-      std::move(data_, data_ + size_, copy);
-      delete[] data_;
+  // Moves [0, size_) into uninitialized storage, copying instead when a throwing move would lose elements.
+  // Trivially copyable elements are counted as copied bytes by CopyElements, everything else as moved bytes.
+  void MoveElements(T *data) {
+    if constexpr (std::is_trivially_copyable<T>::value) {
+      CopyElements(data_, size_, data);
+    } else {
+      INSTRUMENT_ADD("Vector", "bytes_moved", size_ * sizeof(T));
+      size_t i = 0;
+      try {
+        for (; i < size_; ++i) {
+          new (data + i) T(std::move_if_noexcept(data_[i]));
+        }
+      } catch (...) {
+        std::destroy_n(data, i);
+        throw;
+      }
+    }
+  }
+
+  void Replace(T *data, size_t capacity) {
+    std::destroy_n(data_, size_);
+    Deallocate(data_, capacity_);
+    data_ = data;
+    capacity_ = capacity;
+  }
 
-      data_ = copy;
-      capacity_ = new_size;
+  void Realloc(size_t new_capacity) {
+    if (IsMapped(capacity_) && IsMapped(new_capacity)) {
+      Remap(new_capacity);
+      return;
+    }
+    T *data = Allocate(new_capacity);
+    try {
+      MoveElements(data);
+    } catch (...) {
+      Deallocate(data, new_capacity);
+      throw;
     }
+    Replace(data, new_capacity);
   }
 };
 